@@ -0,0 +1,197 @@
+// bench_cb.c - baseline throughput of cb_write/cb_read on a plain buffer,
+// one line per case, for tracking across releases (make bench).
+//   stream     keep the buffer at a fill level, then write a chunk and read
+//              a chunk per step; never overflows
+//   overwrite  buffer kept full, every write evicts the oldest chunk
+//   wrap       capacity not a power of two and chunk ~3/4 of it, so nearly
+//              every copy is split at the end of the storage
+// Capacities 16 B to 64 MiB, chunks 1 B to 64 KiB, fill 0/50/90%. Each case
+// moves at least -m MiB and reports the best of -r repetitions. Cycles are
+// TSC ticks (x86 only, otherwise nan/null).
+//
+// usage: bench_cb [-j] [-c cpu] [-m mib] [-r reps] [-p pattern]
+//   -j  JSON lines instead of CSV
+//   -c  pin to that CPU first
+//   -p  only run stream, overwrite or wrap
+#define _GNU_SOURCE
+#include <math.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "circular_buffer.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+static uint64_t ticks(void) { return __rdtsc(); }
+#else
+#define HAVE_TSC 0
+static uint64_t ticks(void) { return 0; }
+#endif
+
+typedef enum { PAT_STREAM, PAT_OVERWRITE, PAT_WRAP } Pattern;
+
+static const char* const pat_name[] = {"stream", "overwrite", "wrap"};
+
+typedef struct {
+    double   sec;
+    uint64_t cycles;
+} Sample;
+
+static int json;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Top the buffer up to level bytes (also faults in the storage). */
+static void fill_to(CircularBuffer* cb, size_t capacity, size_t level, const uint8_t* src, size_t src_len) {
+    for (size_t done = 0; done < capacity; ) {
+        size_t n = capacity - done < src_len ? capacity - done : src_len;
+        cb_write(cb, src, n);
+        done += n;
+    }
+    uint8_t sink[4096];
+    while (capacity - cb_available(cb) > level) {
+        size_t extra = capacity - cb_available(cb) - level;
+        cb_read(cb, sink, extra < sizeof sink ? extra : sizeof sink);
+    }
+    cb_clear_overflow(cb);
+}
+
+/* One timed pass; returns the bytes written. */
+static uint64_t pass(CircularBuffer* cb, Pattern pat, size_t chunk, uint64_t steps,
+                     const uint8_t* src, uint8_t* dst, Sample* s) {
+    double t0 = now_sec();
+    uint64_t c0 = ticks();
+    switch (pat) {
+    case PAT_STREAM:
+    case PAT_WRAP:
+        for (uint64_t i = 0; i < steps; ++i) {
+            cb_write(cb, src, chunk);
+            cb_read(cb, dst, chunk);
+        }
+        break;
+    case PAT_OVERWRITE:
+        for (uint64_t i = 0; i < steps; ++i) {
+            cb_write(cb, src, chunk);
+        }
+        break;
+    }
+    s->cycles = ticks() - c0;
+    s->sec = now_sec() - t0;
+    return steps * chunk;
+}
+
+static void report(Pattern pat, size_t capacity, size_t chunk, unsigned fill, uint64_t bytes, Sample best) {
+    double mbs = bytes / best.sec / 1e6;
+    double ns_op = best.sec * 1e9 / (double)(bytes / chunk);
+    double cpb = HAVE_TSC ? (double)best.cycles / (double)bytes : NAN;
+    if (json) {
+        printf("{\"pattern\":\"%s\",\"capacity\":%zu,\"chunk\":%zu,\"fill_pct\":%u,"
+               "\"bytes\":%llu,\"seconds\":%.6f,\"mb_per_s\":%.1f,\"ns_per_op\":%.2f,",
+               pat_name[pat], capacity, chunk, fill, (unsigned long long)bytes, best.sec, mbs, ns_op);
+        if (HAVE_TSC) printf("\"cycles_per_byte\":%.4f}\n", cpb);
+        else printf("\"cycles_per_byte\":null}\n");
+    } else {
+        printf("%s,%zu,%zu,%u,%llu,%.6f,%.1f,%.2f,%.4f\n", pat_name[pat], capacity, chunk, fill,
+               (unsigned long long)bytes, best.sec, mbs, ns_op, cpb);
+    }
+    fflush(stdout);
+}
+
+static void run(Pattern pat, size_t capacity, size_t chunk, size_t fill, uint64_t min_bytes, int reps,
+                const uint8_t* src, uint8_t* dst) {
+    CircularBuffer* cb = cb_create(capacity);
+    if (!cb) {
+        fprintf(stderr, "cb_create(%zu) failed\n", capacity);
+        return;
+    }
+    size_t level = pat == PAT_OVERWRITE ? capacity : pat == PAT_WRAP ? capacity - chunk
+                                                   : capacity * fill / 100;
+    uint64_t steps = (min_bytes + chunk - 1) / chunk;
+    Sample best = {0, 0}, s;
+    uint64_t bytes = 0;
+    for (int r = 0; r < reps; ++r) {
+        fill_to(cb, capacity, level, src, chunk > 4096 ? chunk : 4096);
+        bytes = pass(cb, pat, chunk, steps, src, dst, &s);
+        if (r == 0 || s.sec < best.sec) best = s;
+    }
+    cb_destroy(cb);
+    report(pat, capacity, chunk, (unsigned)(100 * level / capacity), bytes, best);
+}
+
+int main(int argc, char** argv) {
+    int cpu = -1, reps = 3, only = -1, opt;
+    uint64_t mib = 16;
+    while ((opt = getopt(argc, argv, "jc:m:r:p:")) != -1) {
+        switch (opt) {
+        case 'j': json = 1; break;
+        case 'c': cpu = atoi(optarg); break;
+        case 'm': mib = strtoull(optarg, NULL, 0); break;
+        case 'r': reps = atoi(optarg); break;
+        case 'p':
+            for (int p = PAT_STREAM; p <= PAT_WRAP; ++p) {
+                if (strcmp(optarg, pat_name[p]) == 0) only = p;
+            }
+            if (only >= 0) break;
+            /* fall through */
+        default:
+            fprintf(stderr, "usage: %s [-j] [-c cpu] [-m mib] [-r reps] [-p stream|overwrite|wrap]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (reps < 1) reps = 1;
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof set, &set) != 0) {
+            perror("sched_setaffinity");
+            return 1;
+        }
+    }
+
+    static const size_t caps[] = {16, 256, 4096, 65536, 1u << 20, 16u << 20, 64u << 20};
+    static const size_t chunks[] = {1, 8, 64, 512, 4096, 65536};
+    static const unsigned fills[] = {0, 50, 90};
+    enum { NCAPS = sizeof caps / sizeof caps[0], NCHUNKS = sizeof chunks / sizeof chunks[0] };
+    uint64_t min_bytes = mib << 20;
+
+    uint8_t* src = malloc(65536);
+    uint8_t* dst = malloc(65536);
+    for (size_t i = 0; i < 65536; ++i) src[i] = (uint8_t)(i * 131u);
+
+    if (!json) printf("pattern,capacity,chunk,fill_pct,bytes,seconds,mb_per_s,ns_per_op,cycles_per_byte\n");
+    for (size_t c = 0; c < NCAPS; ++c) {
+        for (size_t k = 0; k < NCHUNKS; ++k) {
+            size_t cap = caps[c], chunk = chunks[k];
+            if (only < 0 || only == PAT_STREAM) {
+                for (size_t f = 0; f < sizeof fills / sizeof fills[0]; ++f) {
+                    if (cap * fills[f] / 100 + chunk <= cap) {
+                        run(PAT_STREAM, cap, chunk, fills[f], min_bytes, reps, src, dst);
+                    }
+                }
+            }
+            if ((only < 0 || only == PAT_OVERWRITE) && chunk <= cap) {
+                run(PAT_OVERWRITE, cap, chunk, 100, min_bytes, reps, src, dst);
+            }
+            // 3/4 of a slightly odd capacity: each step's copies straddle the end
+            size_t odd = cap - cap / 16 + 3;
+            size_t wchunk = odd / 4 * 3;
+            if ((only < 0 || only == PAT_WRAP) && wchunk >= chunk && wchunk <= 65536 &&
+                (k + 1 == NCHUNKS || chunks[k + 1] > wchunk)) {
+                run(PAT_WRAP, odd, wchunk, 0, min_bytes, reps, src, dst);
+            }
+        }
+    }
+    free(src);
+    free(dst);
+    return 0;
+}
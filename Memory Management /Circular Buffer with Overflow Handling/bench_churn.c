@@ -0,0 +1,88 @@
+// bench_churn.c - per-connection buffer churn: set up a batch of buffers,
+// push one small message through each, tear them all down, repeat.
+//   two-malloc  what cb_create used to do: struct and data allocated apart
+//   cb_create   one allocation, data right behind the struct
+//   cb_init     no allocation: the buffer is embedded in a preallocated
+//               connection object (a pool slot)
+//
+// usage: bench_churn [connections] [buffer_bytes] [rounds]
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "circular_buffer.h"
+
+typedef struct {
+    CircularBuffer* cb;
+    void*           object;    // two-malloc: the separate struct block
+    uint8_t*        data;      // two-malloc: the separate data block
+} Slot;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* The pool for cb_init: struct and data of each connection side by side. */
+static uint8_t* pool;
+static size_t   pool_stride;
+
+static void setup(Slot* s, int mode, size_t i, size_t bytes) {
+    switch (mode) {
+    case 0:
+        s->object = aligned_alloc(CB_OBJECT_ALIGN, CB_OBJECT_SIZE);
+        s->data = malloc(bytes);
+        s->cb = cb_init(s->object, s->data, bytes);
+        break;
+    case 1:
+        s->cb = cb_create(bytes);
+        break;
+    default: {
+        uint8_t* slot = pool + i * pool_stride;
+        s->cb = cb_init(slot, slot + CB_OBJECT_SIZE, bytes);
+        break;
+    }
+    }
+}
+
+static void teardown(Slot* s, int mode) {
+    cb_destroy(s->cb);
+    if (mode == 0) {
+        free(s->object);
+        free(s->data);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t conns = argc > 1 ? strtoull(argv[1], NULL, 0) : 4096;
+    size_t bytes = argc > 2 ? strtoull(argv[2], NULL, 0) : 4096;
+    size_t rounds = argc > 3 ? strtoull(argv[3], NULL, 0) : 200;
+    static const char* const names[] = {"two-malloc", "cb_create", "cb_init"};
+
+    Slot* slots = calloc(conns, sizeof *slots);
+    pool_stride = (CB_OBJECT_SIZE + bytes + CB_OBJECT_ALIGN - 1) & ~(size_t)(CB_OBJECT_ALIGN - 1);
+    pool = aligned_alloc(CB_OBJECT_ALIGN, pool_stride * conns);
+    uint8_t msg[64] = {1}, out[64];
+
+    printf("%zu connections x %zu B buffers, %zu rounds\n", conns, bytes, rounds);
+    for (int mode = 0; mode < 3; ++mode) {
+        uint64_t check = 0;
+        double t0 = now_sec();
+        for (size_t r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < conns; ++i) setup(&slots[i], mode, i, bytes);
+            for (size_t i = 0; i < conns; ++i) {
+                cb_write(slots[i].cb, msg, sizeof msg);
+                check += (uint64_t)cb_read(slots[i].cb, out, sizeof out);
+            }
+            for (size_t i = 0; i < conns; ++i) teardown(&slots[i], mode);
+        }
+        double dt = now_sec() - t0;
+        printf("%-10s: %7.1f ns per setup+message+teardown (%llu B moved)\n",
+               names[mode], dt * 1e9 / ((double)conns * rounds), (unsigned long long)check);
+    }
+    free(pool);
+    free(slots);
+    return 0;
+}
@@ -0,0 +1,83 @@
+// bench_mirrored.c - plain vs mirrored CircularBuffer, small and large records.
+//
+// Writer and reader on one thread: fill the buffer about half-way with
+// records, read them back, repeat. The reader sums every byte (stands in for
+// a parser). Two read paths:
+//   copy      cb_read into a local record buffer
+//   in-place  cb_data + cb_consume; a record split by the wrap point has to
+//             be copied out first (never happens when mirrored)
+//
+// usage: bench_mirrored [mib_per_run]
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "circular_buffer.h"
+
+#define CAPACITY (64u * 1024u)
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t sum_bytes(const uint8_t* p, size_t n) {
+    uint64_t s = 0;
+    for (size_t i = 0; i < n; ++i) s += p[i];
+    return s;
+}
+
+static void run(int mirrored, int in_place, size_t rec, uint64_t total) {
+    static uint8_t in[CAPACITY], out[CAPACITY];
+    CircularBuffer* cb = mirrored ? cb_create_mirrored(CAPACITY) : cb_create(CAPACITY);
+    if (!cb || cb_is_mirrored(cb) != mirrored) {
+        printf("mirrored mode not available\n");
+        cb_destroy(cb);
+        return;
+    }
+    for (size_t i = 0; i < rec; ++i) in[i] = (uint8_t)i;
+    // an odd batch size keeps the wrap point moving through the records
+    size_t batch = ((CAPACITY / 2u) / rec) | 1u;
+    uint64_t records = total / rec, done = 0, sum = 0, split = 0;
+
+    double t0 = now_sec();
+    while (done < records) {
+        size_t n = records - done < batch ? (size_t)(records - done) : batch;
+        for (size_t i = 0; i < n; ++i) cb_write(cb, in, rec);
+        for (size_t i = 0; i < n; ++i) {
+            size_t len;
+            const uint8_t* p = in_place ? cb_data(cb, &len) : NULL;
+            if (p && len >= rec) {
+                sum += sum_bytes(p, rec);
+                cb_consume(cb, rec);
+            } else {
+                cb_read(cb, out, rec);
+                sum += sum_bytes(out, rec);
+                split += in_place;  // record straddled the wrap point
+            }
+        }
+        done += n;
+    }
+    double dt = now_sec() - t0;
+
+    printf("%-8s %-8s %5zu B: %8.2f Mrec/s %8.0f MB/s  split=%-7llu sum=%llu\n",
+           mirrored ? "mirrored" : "plain", in_place ? "in-place" : "copy", rec,
+           records / dt / 1e6, records * rec / dt / 1e6,
+           (unsigned long long)split, (unsigned long long)sum);
+    cb_destroy(cb);
+}
+
+int main(int argc, char** argv) {
+    uint64_t total = (argc > 1 ? strtoull(argv[1], NULL, 0) : 1024u) * 1024u * 1024u;
+    static const size_t recs[] = {16, 61, 1500, 4000};
+    printf("capacity %u B, %llu MiB per run\n", CAPACITY, (unsigned long long)(total >> 20));
+    for (size_t r = 0; r < sizeof recs / sizeof recs[0]; ++r) {
+        for (int m = 0; m < 2; ++m) {
+            run(m, 0, recs[r], total);
+            run(m, 1, recs[r], total);
+        }
+    }
+    return 0;
+}
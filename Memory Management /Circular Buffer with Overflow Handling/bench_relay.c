@@ -0,0 +1,133 @@
+// bench_relay.c - fd -> CircularBuffer -> fd relay, copying vs zero-copy.
+//
+// A source thread writes into one fd, a sink thread drains another, the main
+// thread relays between them through a CircularBuffer:
+//   copy   read() into a local buffer, cb_write, cb_read, write()
+//          (two extra user-space copies of every byte)
+//   spans  cb_read_from_fd / cb_write_to_fd: readv/writev straight into
+//          and out of the buffer (only the kernel copies)
+// Both do the same syscalls, so the difference is the copying. Run over
+// pipes and over AF_UNIX socketpairs.
+//
+// usage: bench_relay [mib_per_run] [capacity]
+#define _DEFAULT_SOURCE
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "circular_buffer.h"
+
+#define CHUNK (64u * 1024u)
+
+static uint64_t total;
+static size_t   capacity = 256u * 1024u;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void* source(void* arg) {
+    static uint8_t chunk[CHUNK];
+    int fd = *(int*)arg;
+    for (uint32_t i = 0; i < CHUNK; ++i) chunk[i] = (uint8_t)i;
+    for (uint64_t sent = 0; sent < total; ) {
+        size_t n = total - sent < CHUNK ? (size_t)(total - sent) : CHUNK;
+        ssize_t w = write(fd, chunk, n);
+        if (w <= 0) break;
+        sent += (uint64_t)w;
+    }
+    close(fd);
+    return NULL;
+}
+
+static void* sink(void* arg) {
+    static uint8_t buf[CHUNK];
+    int fd = *(int*)arg;
+    uint64_t* got = malloc(sizeof *got);
+    *got = 0;
+    for (;;) {
+        ssize_t n = read(fd, buf, sizeof buf);
+        if (n <= 0) break;
+        *got += (uint64_t)n;
+    }
+    return got;
+}
+
+static int write_all(int fd, const uint8_t* p, size_t n) {
+    while (n) {
+        ssize_t w = write(fd, p, n);
+        if (w <= 0) return -1;
+        p += w;
+        n -= (size_t)w;
+    }
+    return 0;
+}
+
+static void relay_copy(CircularBuffer* cb, int in, int out) {
+    static uint8_t rx[CHUNK], tx[CHUNK];
+    for (;;) {
+        size_t room = cb_available(cb) < CHUNK ? cb_available(cb) : CHUNK;
+        ssize_t n = read(in, rx, room);
+        if (n <= 0) break;
+        cb_write(cb, rx, (size_t)n);
+        int m;
+        while ((m = cb_read(cb, tx, sizeof tx)) > 0) {
+            if (write_all(out, tx, (size_t)m) != 0) return;
+        }
+    }
+}
+
+static void relay_spans(CircularBuffer* cb, int in, int out) {
+    for (;;) {
+        if (cb_read_from_fd(cb, in) <= 0) break;
+        while (!cb_is_empty(cb)) {
+            if (cb_write_to_fd(cb, out) < 0) return;
+        }
+    }
+}
+
+static void run(const char* transport, const char* mode,
+                void (*relay)(CircularBuffer*, int, int)) {
+    int a[2], b[2];
+    if (transport[0] == 'p' ? pipe(a) || pipe(b)
+                            : socketpair(AF_UNIX, SOCK_STREAM, 0, a) ||
+                              socketpair(AF_UNIX, SOCK_STREAM, 0, b)) {
+        perror(transport);
+        exit(1);
+    }
+    CircularBuffer* cb = cb_create(capacity);
+    pthread_t src, dst;
+    void* got;
+
+    double t0 = now_sec();
+    pthread_create(&src, NULL, source, &a[1]);
+    pthread_create(&dst, NULL, sink, &b[0]);
+    relay(cb, a[0], b[1]);
+    close(b[1]);
+    pthread_join(src, NULL);
+    pthread_join(dst, &got);
+    double dt = now_sec() - t0;
+
+    printf("%-10s %-5s: %8.0f MB/s  %s\n", transport, mode, total / dt / 1e6,
+           *(uint64_t*)got == total ? "ok" : "SHORT");
+    free(got);
+    close(a[0]);
+    close(b[0]);
+    cb_destroy(cb);
+}
+
+int main(int argc, char** argv) {
+    total = (argc > 1 ? strtoull(argv[1], NULL, 0) : 1024u) * 1024u * 1024u;
+    if (argc > 2) capacity = strtoull(argv[2], NULL, 0);
+    printf("capacity %zu B, %llu MiB per run\n", capacity, (unsigned long long)(total >> 20));
+    run("pipe", "copy", relay_copy);
+    run("pipe", "spans", relay_spans);
+    run("socketpair", "copy", relay_copy);
+    run("socketpair", "spans", relay_spans);
+    return 0;
+}
@@ -0,0 +1,143 @@
+// bench_threads.c - one producer thread, one consumer thread, three ways of
+// sharing a CircularBuffer:
+//   mutex     CB_MODE_PLAIN with every call wrapped in an external mutex,
+//             sched_yield() when the buffer is full/empty
+//   spsc      CB_MODE_SPSC, no lock, sched_yield() when full/empty
+//   blocking  CB_MODE_BLOCKING, cb_write_wait / cb_read_timeout sleep on
+//             the condvars
+// The producer writes a counting pattern in chunk-sized writes, the consumer
+// reads chunk-sized blocks and checks it. Swept over buffer and chunk sizes.
+//
+// usage: bench_threads [mib_per_run]
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <time.h>
+#include "circular_buffer.h"
+
+typedef enum { SHARE_MUTEX, SHARE_SPSC, SHARE_BLOCKING } Share;
+
+static const char* const share_name[] = {"mutex", "spsc", "blocking"};
+
+typedef struct {
+    CircularBuffer* cb;
+    Share           share;
+    size_t          chunk;
+    uint64_t        total;
+} Run;
+
+static pthread_mutex_t ext_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static double cpu_sec(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec +
+           (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+/* Write what fits without overwriting; 0 when full. */
+static size_t put(const Run* r, const uint8_t* p, size_t n) {
+    switch (r->share) {
+    case SHARE_MUTEX: {
+        pthread_mutex_lock(&ext_lock);
+        size_t room = cb_available(r->cb);
+        int w = cb_write(r->cb, p, n < room ? n : room);
+        pthread_mutex_unlock(&ext_lock);
+        return (size_t)w;
+    }
+    case SHARE_SPSC:
+        return (size_t)cb_write(r->cb, p, n);
+    default:
+        return (size_t)cb_write_wait(r->cb, p, n, -1);
+    }
+}
+
+static size_t get(const Run* r, uint8_t* p, size_t n) {
+    switch (r->share) {
+    case SHARE_MUTEX: {
+        pthread_mutex_lock(&ext_lock);
+        int got = cb_read(r->cb, p, n);
+        pthread_mutex_unlock(&ext_lock);
+        return (size_t)got;
+    }
+    case SHARE_SPSC:
+        return (size_t)cb_read(r->cb, p, n);
+    default:
+        return (size_t)cb_read_timeout(r->cb, p, n, 100);
+    }
+}
+
+static void* producer(void* arg) {
+    const Run* r = arg;
+    uint8_t* chunk = malloc(r->chunk);
+    uint8_t next = 0;
+    for (uint64_t sent = 0; sent < r->total; ) {
+        size_t n = r->total - sent < r->chunk ? (size_t)(r->total - sent) : r->chunk;
+        for (size_t i = 0; i < n; ++i) chunk[i] = next++;
+        for (size_t off = 0; off < n; ) {
+            size_t w = put(r, chunk + off, n - off);
+            if (w == 0) sched_yield();
+            off += w;
+        }
+        sent += n;
+    }
+    free(chunk);
+    return NULL;
+}
+
+static void run(Share share, size_t size, size_t chunk, uint64_t total) {
+    Run r = { NULL, share, chunk, total };
+    r.cb = cb_create_mode(size, share == SHARE_SPSC ? CB_MODE_SPSC :
+                                share == SHARE_BLOCKING ? CB_MODE_BLOCKING : CB_MODE_PLAIN);
+    uint8_t* buf = malloc(chunk);
+    uint8_t expect = 0;
+    uint64_t errors = 0, reads = 0;
+    pthread_t t;
+
+    double c0 = cpu_sec(), t0 = now_sec();
+    pthread_create(&t, NULL, producer, &r);
+    for (uint64_t got = 0; got < total; ) {
+        size_t n = get(&r, buf, chunk);
+        if (n == 0) {
+            sched_yield();
+            continue;
+        }
+        for (size_t i = 0; i < n; ++i) errors += buf[i] != expect++;
+        got += n;
+        reads++;
+    }
+    pthread_join(t, NULL);
+    double dt = now_sec() - t0, cpu = cpu_sec() - c0;
+
+    printf("%-8s buf %8zu chunk %6zu: %8.0f MB/s  cpu %5.1f%%  %7.0f B/read  errors=%llu\n",
+           share_name[share], size, chunk, total / dt / 1e6, 100.0 * cpu / dt,
+           (double)total / reads, (unsigned long long)errors);
+    free(buf);
+    cb_destroy(r.cb);
+}
+
+int main(int argc, char** argv) {
+    uint64_t total = (argc > 1 ? strtoull(argv[1], NULL, 0) : 256u) * 1024u * 1024u;
+    static const size_t sizes[] = {4096, 65536, 1u << 20};
+    static const size_t chunks[] = {64, 1024, 16384};
+    printf("%llu MiB per run\n", (unsigned long long)(total >> 20));
+    for (size_t s = 0; s < sizeof sizes / sizeof sizes[0]; ++s) {
+        for (size_t c = 0; c < sizeof chunks / sizeof chunks[0]; ++c) {
+            if (chunks[c] > sizes[s]) continue;
+            for (int m = SHARE_MUTEX; m <= SHARE_BLOCKING; ++m) {
+                run((Share)m, sizes[s], chunks[c], total);
+            }
+        }
+    }
+    return 0;
+}
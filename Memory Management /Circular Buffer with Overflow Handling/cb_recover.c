@@ -0,0 +1,64 @@
+// cb_recover.c - dump what a cb_open_file buffer held when its writer died.
+//
+// Opens the file at the size it was created with (which runs the same
+// recovery as a restarting writer), prints a summary to stderr and the
+// stored bytes, oldest first, to stdout.
+//
+// usage: cb_recover [-c] [-q] file
+//   -c  consume: leave the buffer empty afterwards
+//   -q  summary only, no data
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "circular_buffer.h"
+
+int main(int argc, char** argv) {
+    int consume = 0, quiet = 0, opt;
+    while ((opt = getopt(argc, argv, "cq")) != -1) {
+        switch (opt) {
+        case 'c': consume = 1; break;
+        case 'q': quiet = 1; break;
+        default:
+            fprintf(stderr, "usage: %s [-c] [-q] file\n", argv[0]);
+            return 2;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "usage: %s [-c] [-q] file\n", argv[0]);
+        return 2;
+    }
+
+    CircularBuffer* cb = cb_open_file(argv[optind], 0);
+    if (!cb) {
+        perror(argv[optind]);
+        return 1;
+    }
+    CbSpan span[2];
+    size_t stored = cb_peek(cb, span);
+    uint64_t first = cb_file_offset(cb);
+    size_t capacity = stored + cb_available(cb);
+
+    fprintf(stderr, "%s: capacity %zu, %zu bytes stored (stream offsets %llu..%llu)\n",
+            argv[optind], capacity, stored, (unsigned long long)first,
+            (unsigned long long)(first + stored));
+
+    int rc = 0;
+    if (!quiet) {
+        for (int s = 0; s < 2; ++s) {
+            if (span[s].len && fwrite(span[s].data, 1, span[s].len, stdout) != span[s].len) {
+                perror("stdout");
+                rc = 1;
+                break;
+            }
+        }
+    }
+    if (consume && rc == 0) {
+        cb_consume(cb, stored);
+        if (cb_clear_overflow(cb)) {
+            fprintf(stderr, "%s: older data had been overwritten\n", argv[optind]);
+        }
+    }
+    cb_destroy(cb);
+    return rc;
+}
@@ -1,77 +1,487 @@
 // circular_buffer.c       
+#define _GNU_SOURCE // memfd_create
+#include <fcntl.h>    // open
 #include "circular_buffer.h"
 #include <stdlib.h> // malloc, free
+#include <string.h> // memcpy
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>     // clock_gettime
+#include <sys/uio.h>  // readv, writev
+#include <sys/mman.h> // mmap, memfd_create
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // ftruncate, sysconf
 
-/* Opaque type defined here */
+#define CB_CACHE_LINE CB_OBJECT_ALIGN
+
+#define CB_FILE_MAGIC   0x31304c4946424355ull   // "UCBFIL01"
+
+/* First page of a cb_open_file file; the data follows at data_offset.
+ * Positions are stream offsets (bytes ever written / consumed), so the
+ * storage index is offset % size. The stored bytes are [tail_pos,
+ * head_pos). A write first raises pending to its end, then copies, then
+ * moves head_pos: whatever moment the writer dies at, the bytes from
+ * pending - size up to head_pos are intact. */
+typedef struct {
+    uint64_t         magic;
+    uint64_t         size;
+    uint64_t         data_offset;
+    _Atomic uint64_t head_pos;
+    _Atomic uint64_t tail_pos;
+    _Atomic uint64_t pending;
+    atomic_int       overflow;
+} CbFileHeader;
+
+/* Opaque type defined here. In SPSC mode the producer owns head, the
+ * consumer owns tail and they meet only in count; each side sits on its
+ * own cache line, next to the counters only it updates. */
 struct CircularBuffer {
     uint8_t* buffer;
     size_t   size;               // capacity (bytes)
+    size_t   mask;               // size - 1 when size is a power of two, else 0
+    int      mirrored;           // buffer is mapped twice back to back
+    CbMode   mode;
+    CbFileHeader* file;          // cb_open_file: mapped header, else NULL
+    size_t   file_len;           // bytes mapped at file
+    int      heap;               // cb_destroy frees the struct (and inline data)
+    _Alignas(CB_CACHE_LINE)
     size_t   head;               // next write index
+    _Atomic uint64_t bytes_written;      // writer-side counters (cb_stats)
+    _Atomic uint64_t bytes_overwritten;
+    _Atomic uint64_t overflow_events;
+    atomic_size_t    peak;
+    _Alignas(CB_CACHE_LINE)
     size_t   tail;               // next read index
-    size_t   count;              // number of stored bytes
-    int      overflow_occurred;  // sticky overflow flag
+    _Atomic uint64_t bytes_read;         // reader-side counter
+    _Alignas(CB_CACHE_LINE)
+    atomic_size_t count;         // number of stored bytes
+    atomic_int    overflow_occurred;  // sticky overflow flag
+    // CB_MODE_BLOCKING only
+    pthread_mutex_t lock;
+    pthread_cond_t  can_read;    // count reached read_want
+    pthread_cond_t  can_write;   // free space reached write_want
+    size_t          read_want;   // 0 = no reader waiting
+    size_t          write_want;  // 0 = no writer waiting
 };
 
-/* Create a circular buffer of given size. Returns NULL incase of  error. */
+static void cb_setup(CircularBuffer* cb, uint8_t* buffer, size_t size) {
+    cb->buffer = buffer;
+    cb->size = size;
+    cb->mask = (size & (size - 1)) == 0 ? size - 1 : 0;
+    cb->mirrored = 0;
+    cb->mode = CB_MODE_PLAIN;
+    cb->file = NULL;
+    cb->file_len = 0;
+    cb->heap = 0;
+    cb->head = 0;
+    cb->tail = 0;
+    atomic_init(&cb->bytes_written, 0);
+    atomic_init(&cb->bytes_overwritten, 0);
+    atomic_init(&cb->overflow_events, 0);
+    atomic_init(&cb->peak, 0);
+    atomic_init(&cb->bytes_read, 0);
+    atomic_init(&cb->count, 0);
+    atomic_init(&cb->overflow_occurred, 0);
+    cb->read_want = 0;
+    cb->write_want = 0;
+}
+
+_Static_assert(sizeof(CircularBuffer) <= CB_OBJECT_SIZE, "raise CB_OBJECT_SIZE");
+_Static_assert(_Alignof(CircularBuffer) <= CB_OBJECT_ALIGN, "raise CB_OBJECT_ALIGN");
+
+/* Struct plus extra bytes in one block. The struct is cache-line aligned,
+ * so its size is a multiple of it; aligned_alloc wants the total rounded too. */
+static CircularBuffer* cb_alloc(size_t extra) {
+    if (extra > SIZE_MAX - sizeof(CircularBuffer) - CB_CACHE_LINE) {
+        return NULL;
+    }
+    size_t total = (sizeof(CircularBuffer) + extra + CB_CACHE_LINE - 1) & ~(size_t)(CB_CACHE_LINE - 1);
+    return aligned_alloc(CB_CACHE_LINE, total);
+}
+
+/* Create a circular buffer of given size. Returns NULL incase of  error.
+ * One allocation: the data follows the struct. */
 CircularBuffer* cb_create(size_t size) {
     if (size == 0) {
         return NULL;
     }
-    CircularBuffer* cb = malloc(sizeof(*cb));
+    CircularBuffer* cb = cb_alloc(size);
     if (!cb) {
         return NULL;
     }
-    cb->buffer = malloc(size);
-    if (!cb->buffer) {
-        free(cb);
+    cb_setup(cb, (uint8_t*)(cb + 1), size);
+    cb->heap = 1;
+    return cb;
+}
+
+/* Build a buffer in caller memory: mem holds the struct (CB_OBJECT_SIZE
+ * bytes, CB_OBJECT_ALIGN-aligned), storage the data. Nothing is allocated
+ * and cb_destroy frees nothing. Returns NULL on bad arguments. */
+CircularBuffer* cb_init(void* mem, uint8_t* storage, size_t size) {
+    if (!mem || !storage || size == 0 || (uintptr_t)mem % CB_OBJECT_ALIGN != 0) {
         return NULL;
     }
+    CircularBuffer* cb = mem;
+    cb_setup(cb, storage, size);
+    return cb;
+}
 
-    cb->size = size;
-    cb->head = 0;
-    cb->tail = 0;
-    cb->count = 0;
-    cb->overflow_occurred = 0;
+static int cb_init_blocking(CircularBuffer* cb) {
+    pthread_condattr_t attr;
+    if (pthread_condattr_init(&attr) != 0) {
+        return -1;
+    }
+    // deadlines come from CLOCK_MONOTONIC so wall-clock jumps do not matter
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    int err = pthread_mutex_init(&cb->lock, NULL);
+    if (!err && (err = pthread_cond_init(&cb->can_read, &attr)) != 0) {
+        pthread_mutex_destroy(&cb->lock);
+    }
+    if (!err && (err = pthread_cond_init(&cb->can_write, &attr)) != 0) {
+        pthread_cond_destroy(&cb->can_read);
+        pthread_mutex_destroy(&cb->lock);
+    }
+    pthread_condattr_destroy(&attr);
+    return err ? -1 : 0;
+}
+
+/* Create a buffer for use from two threads, see CbMode. Returns NULL on error. */
+CircularBuffer* cb_create_mode(size_t size, CbMode mode) {
+    if (mode != CB_MODE_PLAIN && mode != CB_MODE_SPSC && mode != CB_MODE_BLOCKING) {
+        return NULL;
+    }
+    CircularBuffer* cb = cb_create(size);
+    if (!cb) {
+        return NULL;
+    }
+    if (mode == CB_MODE_BLOCKING && cb_init_blocking(cb) != 0) {
+        cb_destroy(cb);
+        return NULL;
+    }
+    cb->mode = mode;
     return cb;
 }
 
-/* Free all allocated memory; safe to call with NULL. */
+#ifdef __linux__
+/* Map one memfd of size bytes at base and again at base + size. */
+static uint8_t* cb_map_mirrored(size_t size) {
+    int fd = memfd_create("circular_buffer", MFD_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+    uint8_t* base = NULL;
+    if (ftruncate(fd, (off_t)size) == 0) {
+        // reserve the whole 2*size range first so nothing else lands in it
+        void* p = mmap(NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED) {
+            base = p;
+            if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+                mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+                munmap(base, 2 * size);
+                base = NULL;
+            }
+        }
+    }
+    close(fd); // the mappings keep the pages alive
+    return base;
+}
+#endif
+
+/* Create a buffer whose storage is mapped twice, back to back (Linux only).
+ * Falls back to cb_create when size is not a multiple of the page size or
+ * the mapping fails; check with cb_is_mirrored. */
+CircularBuffer* cb_create_mirrored(size_t size) {
+#ifdef __linux__
+    long page = sysconf(_SC_PAGESIZE);
+    if (size == 0 || page <= 0 || size % (size_t)page != 0) {
+        return cb_create(size);
+    }
+    CircularBuffer* cb = cb_alloc(0);
+    if (!cb) {
+        return NULL;
+    }
+    uint8_t* buffer = cb_map_mirrored(size);
+    if (!buffer) {
+        free(cb);
+        return cb_create(size);
+    }
+    cb_setup(cb, buffer, size);
+    cb->heap = 1;
+    cb->mirrored = 1;
+    return cb;
+#else
+    return cb_create(size);
+#endif
+}
+
+/* Free all allocated memory; safe to call with NULL. Caller memory
+ * (cb_init) is left alone. */
 void cb_destroy(CircularBuffer* cb) {
     if (cb) {
-        free(cb->buffer);
-        free(cb);
+        if (cb->mode == CB_MODE_BLOCKING) {
+            pthread_cond_destroy(&cb->can_write);
+            pthread_cond_destroy(&cb->can_read);
+            pthread_mutex_destroy(&cb->lock);
+        }
+#ifdef __linux__
+        if (cb->mirrored) {
+            munmap(cb->buffer, 2 * cb->size);
+        }
+#endif
+        if (cb->file) {
+            munmap(cb->file, cb->file_len);
+        }
+        if (cb->heap) {
+            free(cb);    // cb_create data lives in the same block
+        }
     }
 }
 
+int cb_is_mirrored(const CircularBuffer* cb) {
+    if (!cb) return 0;
+    return cb->mirrored;
+}
+
+CbMode cb_mode(const CircularBuffer* cb) {
+    if (!cb) return CB_MODE_PLAIN;
+    return cb->mode;
+}
+
+/* count is the only field both SPSC sides write: acquire loads pair with
+ * the release updates so the bytes behind a count are visible before it.
+ * In the other modes one thread at a time owns the buffer and a relaxed
+ * load/store pair (plain moves) is enough. */
+static inline size_t cb_count(const CircularBuffer* cb) {
+    return atomic_load_explicit(&cb->count, memory_order_acquire);
+}
+
+static inline void cb_count_add(CircularBuffer* cb, size_t n) {
+    if (cb->mode == CB_MODE_SPSC) {
+        atomic_fetch_add_explicit(&cb->count, n, memory_order_release);
+    } else {
+        atomic_store_explicit(&cb->count, cb_count(cb) + n, memory_order_relaxed);
+    }
+}
+
+static inline void cb_count_sub(CircularBuffer* cb, size_t n) {
+    if (cb->mode == CB_MODE_SPSC) {
+        atomic_fetch_sub_explicit(&cb->count, n, memory_order_release);
+    } else {
+        atomic_store_explicit(&cb->count, cb_count(cb) - n, memory_order_relaxed);
+    }
+}
+
+/* Statistics. Each counter has a single writer (the producer, or the
+ * consumer for bytes_read), so an update is a load and a store, no
+ * read-modify-write; the release store lets cb_stats on another thread
+ * order its loads. -DCB_NO_STATS compiles the updates out (bench_cb_nostats). */
+static inline void cb_stat_add(_Atomic uint64_t* c, uint64_t n) {
+#ifndef CB_NO_STATS
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + n, memory_order_release);
+#else
+    (void)c; (void)n;
+#endif
+}
+
+/* After a write: the buffer now holds count bytes; lost of them went to
+ * the overwrite (or the SPSC drop). */
+static inline void cb_stat_write(CircularBuffer* cb, size_t len, size_t lost, size_t count) {
+#ifndef CB_NO_STATS
+    cb_stat_add(&cb->bytes_written, len);
+    if (lost) {
+        cb_stat_add(&cb->bytes_overwritten, lost);
+        cb_stat_add(&cb->overflow_events, 1);
+    }
+    if (count > atomic_load_explicit(&cb->peak, memory_order_relaxed)) {
+        atomic_store_explicit(&cb->peak, count, memory_order_relaxed);
+    }
+#else
+    (void)cb; (void)len; (void)lost; (void)count;
+#endif
+}
+
+static inline void cb_set_overflow(CircularBuffer* cb) {
+    atomic_store_explicit(&cb->overflow_occurred, 1, memory_order_relaxed);
+    if (cb->file) {
+        atomic_store_explicit(&cb->file->overflow, 1, memory_order_relaxed);
+    }
+}
+
+/* File-backed mode: keep the header's stream offsets in step with head
+ * and tail. Plain stores into the mapping; the page cache keeps them when
+ * the process dies. */
+static inline void cb_file_write_begin(CircularBuffer* cb, size_t len) {
+    uint64_t head = atomic_load_explicit(&cb->file->head_pos, memory_order_relaxed);
+    atomic_store_explicit(&cb->file->pending, head + len, memory_order_relaxed);
+    /* A release store only keeps earlier accesses before it; the fence
+     * keeps the data copy that follows from landing in the mapping ahead
+     * of pending. */
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void cb_file_write_end(CircularBuffer* cb, size_t len) {
+    CbFileHeader* f = cb->file;
+    uint64_t head = atomic_load_explicit(&f->head_pos, memory_order_relaxed) + len;
+    atomic_store_explicit(&f->head_pos, head, memory_order_release);
+    if (head - atomic_load_explicit(&f->tail_pos, memory_order_relaxed) > cb->size) {
+        atomic_store_explicit(&f->tail_pos, head - cb->size, memory_order_relaxed);
+    }
+}
+
+static inline void cb_file_consume(CircularBuffer* cb, size_t n) {
+    CbFileHeader* f = cb->file;
+    uint64_t tail = atomic_load_explicit(&f->tail_pos, memory_order_relaxed) + n;
+    atomic_store_explicit(&f->tail_pos, tail, memory_order_release);
+}
+
 int cb_is_full(const CircularBuffer* cb) {
     if (!cb) return 0;
-    return cb->count == cb->size;
+    return cb_count(cb) == cb->size;
 }
 
 int cb_is_empty(const CircularBuffer* cb) {
     if (!cb) return 1;
-    return cb->count == 0;
+    return cb_count(cb) == 0;
+}
+
+/* Blocking mode: wake a waiter once its threshold is met, not per byte. */
+static void cb_wake_locked(CircularBuffer* cb) {
+    size_t count = cb_count(cb);
+    if (cb->read_want && count >= cb->read_want) {
+        pthread_cond_signal(&cb->can_read);
+    }
+    if (cb->write_want && cb->size - count >= cb->write_want) {
+        pthread_cond_signal(&cb->can_write);
+    }
+}
+
+/* Reduce an index in [0, 2*size) to [0, size): mask for power-of-two sizes,
+ * one compare otherwise. No division on the data path. */
+static inline size_t cb_wrap(const CircularBuffer* cb, size_t idx) {
+    if (cb->mask) return idx & cb->mask;
+    return idx >= cb->size ? idx - cb->size : idx;
 }
 
-/* Write len bytes; overwrite oldest when full. Returns bytes written or -1. */
+/* Copy len (<= size) bytes in at index pos, in at most two memcpy calls
+ * (one when mirrored: the second mapping continues past the end). */
+static void cb_copy_in(CircularBuffer* cb, size_t pos, const uint8_t* src, size_t len) {
+    if (cb->mirrored) {
+        memcpy(cb->buffer + pos, src, len);
+        return;
+    }
+    size_t first = cb->size - pos;
+    if (first > len) first = len;
+    memcpy(cb->buffer + pos, src, first);
+    memcpy(cb->buffer, src + first, len - first);
+}
+
+/* Copy len (<= count) bytes out from index pos, in at most two memcpy calls. */
+static void cb_copy_out(const CircularBuffer* cb, size_t pos, uint8_t* dst, size_t len) {
+    if (cb->mirrored) {
+        memcpy(dst, cb->buffer + pos, len);
+        return;
+    }
+    size_t first = cb->size - pos;
+    if (first > len) first = len;
+    memcpy(dst, cb->buffer + pos, first);
+    memcpy(dst + first, cb->buffer, len - first);
+}
+
+/* Length of the first span of len bytes starting at pos: up to the end of
+ * the storage, or all of it when mirrored. */
+static inline size_t cb_first_len(const CircularBuffer* cb, size_t pos, size_t len) {
+    size_t first = cb->size - pos;
+    return cb->mirrored || len < first ? len : first;
+}
+
+/* Plain write: overwrite oldest when full. */
+static int cb_write_overwrite(CircularBuffer* cb, const uint8_t* data, size_t len) {
+    size_t count = cb_count(cb);
+    size_t lost = 0;
+    if (len > cb->size - count) {
+        cb_set_overflow(cb);
+        lost = len - (cb->size - count);    // oldest stored bytes, then leading input
+    }
+    cb_stat_write(cb, len, lost, count + len - lost);
+    if (cb->file) {
+        cb_file_write_begin(cb, len);
+    }
+    if (len >= cb->size) {
+        // Everything before the last size bytes would be overwritten anyway:
+        // store only those, ending where a byte-by-byte write would end.
+        size_t skip = len - cb->size;
+        size_t pos = cb->mask ? (cb->head + skip) & cb->mask
+                              : (cb->head + skip % cb->size) % cb->size;
+        cb_copy_in(cb, pos, data + skip, cb->size);
+        cb->head = pos;
+        cb->tail = pos;
+        cb_count_add(cb, cb->size - count);
+        if (cb->file) {
+            cb_file_write_end(cb, len);
+        }
+        return (int)len;
+    }
+    cb_copy_in(cb, cb->head, data, len);
+    cb->head = cb_wrap(cb, cb->head + len);
+    if (count + len > cb->size) {
+        // Buffer was too full: drop the oldest bytes (advance tail)
+        cb->tail = cb->head;
+        cb_count_add(cb, cb->size - count);
+    } else {
+        cb_count_add(cb, len);
+    }
+    if (cb->file) {
+        cb_file_write_end(cb, len);
+    }
+    return (int)len;
+}
+
+/* SPSC write: the producer may not move tail, so what does not fit is
+ * dropped (newest bytes) and flagged as overflow. */
+static int cb_write_drop(CircularBuffer* cb, const uint8_t* data, size_t len) {
+    size_t room = cb->size - cb_count(cb);
+    size_t n = len < room ? len : room;
+    if (n < len) {
+        cb_set_overflow(cb);
+    }
+    cb_copy_in(cb, cb->head, data, n);
+    cb->head = cb_wrap(cb, cb->head + n);
+    cb_stat_write(cb, n, len - n, cb->size - room + n);
+    cb_count_add(cb, n);
+    return (int)n;
+}
+
+/* Write len bytes; overwrite oldest when full (SPSC mode: drop what does
+ * not fit). Returns bytes written or -1. */
 int cb_write(CircularBuffer* cb, const uint8_t* data, size_t len) {
     if (!cb || !data) {
         return -1;
     }
-    int written = 0;
-    for (size_t i = 0; i < len; ++i) {
-        if (cb->count == cb->size) {
-            // Buffer is full: drop the oldest byte (advance tail)
-            cb->overflow_occurred = 1;
-            cb->tail = (cb->tail + 1) % cb->size;
-        } else {
-            cb->count++;
-        }
-        cb->buffer[cb->head] = data[i];
-        cb->head = (cb->head + 1) % cb->size;
-        written++;
+    if (cb->mode == CB_MODE_SPSC) {
+        return cb_write_drop(cb, data, len);
     }
-    return written;
+    if (cb->mode == CB_MODE_BLOCKING) {
+        pthread_mutex_lock(&cb->lock);
+        int n = cb_write_overwrite(cb, data, len);
+        cb_wake_locked(cb);
+        pthread_mutex_unlock(&cb->lock);
+        return n;
+    }
+    return cb_write_overwrite(cb, data, len);
+}
+
+static size_t cb_take(CircularBuffer* cb, uint8_t* out, size_t len) {
+    size_t count = cb_count(cb);
+    size_t n = len < count ? len : count;
+    cb_copy_out(cb, cb->tail, out, n);
+    cb->tail = cb_wrap(cb, cb->tail + n);
+    cb_stat_add(&cb->bytes_read, n);
+    cb_count_sub(cb, n);
+    if (cb->file) {
+        cb_file_consume(cb, n);
+    }
+    return n;
 }
 
 /* Read up to len bytes into out; returns bytes read or -1. */
@@ -79,25 +489,372 @@ int cb_read(CircularBuffer* cb, uint8_t* out, size_t len) {
     if (!cb || !out) {
         return -1;
     }
-    int read = 0;
-    while (len > 0 && cb->count > 0) {
-        out[read] = cb->buffer[cb->tail];
-        cb->tail = (cb->tail + 1) % cb->size;
-        cb->count--;
-        read++;
-        len--;
+    if (cb->mode == CB_MODE_BLOCKING) {
+        pthread_mutex_lock(&cb->lock);
+        size_t n = cb_take(cb, out, len);
+        cb_wake_locked(cb);
+        pthread_mutex_unlock(&cb->lock);
+        return (int)n;
+    }
+    return (int)cb_take(cb, out, len); // may be 0 if empty
+}
+
+/* Absolute CLOCK_MONOTONIC deadline timeout_ms from now; NULL for < 0 (forever). */
+static const struct timespec* cb_deadline(int timeout_ms, struct timespec* ts) {
+    if (timeout_ms < 0) {
+        return NULL;
+    }
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += timeout_ms / 1000;
+    ts->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+/* Returns nonzero once the deadline has passed. */
+static int cb_wait_locked(CircularBuffer* cb, pthread_cond_t* cv, const struct timespec* deadline) {
+    if (!deadline) {
+        pthread_cond_wait(cv, &cb->lock);
+        return 0;
+    }
+    return pthread_cond_timedwait(cv, &cb->lock, deadline) == ETIMEDOUT;
+}
+
+/* Blocking mode: write all len bytes, sleeping while the buffer is full.
+ * Never overwrites. The writer sleeps until a quarter of the buffer (or
+ * all it still needs) is free, so it is not woken per byte read.
+ * Returns bytes written (< len on timeout) or -1. */
+int cb_write_wait(CircularBuffer* cb, const uint8_t* data, size_t len, int timeout_ms) {
+    if (!cb || !data || cb->mode != CB_MODE_BLOCKING) {
+        return -1;
+    }
+    struct timespec ts;
+    const struct timespec* deadline = cb_deadline(timeout_ms, &ts);
+    size_t batch = cb->size / 4 ? cb->size / 4 : 1;
+    size_t done = 0;
+    int timed_out = 0;
+
+    pthread_mutex_lock(&cb->lock);
+    for (;;) {
+        size_t room = cb->size - cb_count(cb);
+        size_t n = len - done < room ? len - done : room;
+        if (n) {
+            cb_copy_in(cb, cb->head, data + done, n);
+            cb->head = cb_wrap(cb, cb->head + n);
+            cb_stat_write(cb, n, 0, cb->size - room + n);
+            cb_count_add(cb, n);
+            done += n;
+            cb_wake_locked(cb);
+        }
+        if (done == len || timed_out) {
+            break;
+        }
+        cb->write_want = len - done < batch ? len - done : batch;
+        timed_out = cb_wait_locked(cb, &cb->can_write, deadline);
+        cb->write_want = 0;
+    }
+    pthread_mutex_unlock(&cb->lock);
+    return (int)done;
+}
+
+/* Blocking mode: sleep until len bytes (at most the capacity) are stored
+ * or the timeout expires, then read up to len. One wakeup per batch, not
+ * per write. Returns bytes read (0 on timeout with nothing stored) or -1. */
+int cb_read_timeout(CircularBuffer* cb, uint8_t* out, size_t len, int timeout_ms) {
+    if (!cb || !out || cb->mode != CB_MODE_BLOCKING) {
+        return -1;
+    }
+    struct timespec ts;
+    const struct timespec* deadline = cb_deadline(timeout_ms, &ts);
+    size_t want = len < cb->size ? len : cb->size;
+
+    pthread_mutex_lock(&cb->lock);
+    while (cb_count(cb) < want) {
+        cb->read_want = want;
+        int timed_out = cb_wait_locked(cb, &cb->can_read, deadline);
+        cb->read_want = 0;
+        if (timed_out) {
+            break;
+        }
+    }
+    size_t n = cb_take(cb, out, len);
+    cb_wake_locked(cb);
+    pthread_mutex_unlock(&cb->lock);
+    return (int)n;
+}
+
+/* Oldest stored byte; *len gets how many follow it contiguously (all of
+ * them when mirrored, up to the end of the storage otherwise). */
+const uint8_t* cb_data(const CircularBuffer* cb, size_t* len) {
+    if (!cb || !len) {
+        return NULL;
+    }
+    *len = cb_first_len(cb, cb->tail, cb_count(cb));
+    return cb->buffer + cb->tail;
+}
+
+/* Drop up to len of the oldest bytes without copying; returns bytes dropped or -1. */
+int cb_consume(CircularBuffer* cb, size_t len) {
+    if (!cb) {
+        return -1;
+    }
+    if (cb->mode == CB_MODE_BLOCKING) {
+        pthread_mutex_lock(&cb->lock);
+    }
+    size_t count = cb_count(cb);
+    size_t n = len < count ? len : count;
+    cb->tail = cb_wrap(cb, cb->tail + n);
+    cb_stat_add(&cb->bytes_read, n);
+    cb_count_sub(cb, n);
+    if (cb->file) {
+        cb_file_consume(cb, n);
+    }
+    if (cb->mode == CB_MODE_BLOCKING) {
+        cb_wake_locked(cb);
+        pthread_mutex_unlock(&cb->lock);
+    }
+    return (int)n;
+}
+
+/* Stored bytes as up to two spans, oldest first. Returns the total. */
+size_t cb_peek(const CircularBuffer* cb, CbSpan span[2]) {
+    if (!cb || !span) {
+        return 0;
+    }
+    size_t count = cb_count(cb);
+    size_t first = cb_first_len(cb, cb->tail, count);
+    span[0].data = cb->buffer + cb->tail;
+    span[0].len = first;
+    span[1].data = cb->buffer;
+    span[1].len = count - first;
+    return count;
+}
+
+/* Free space as up to two writable spans. Returns the total. */
+size_t cb_reserve(CircularBuffer* cb, CbMutSpan span[2]) {
+    if (!cb || !span) {
+        return 0;
+    }
+    size_t avail = cb->size - cb_count(cb);
+    size_t first = cb_first_len(cb, cb->head, avail);
+    span[0].data = cb->buffer + cb->head;
+    span[0].len = first;
+    span[1].data = cb->buffer;
+    span[1].len = avail - first;
+    return avail;
+}
+
+/* Publish len bytes filled in through cb_reserve. Returns len, or -1 if
+ * len exceeds the free space. */
+int cb_commit(CircularBuffer* cb, size_t len) {
+    if (!cb) {
+        return -1;
+    }
+    if (cb->mode == CB_MODE_BLOCKING) {
+        pthread_mutex_lock(&cb->lock);
+    }
+    int ret = -1;
+    size_t count = cb_count(cb);
+    if (len <= cb->size - count) {
+        cb->head = cb_wrap(cb, cb->head + len);
+        cb_stat_write(cb, len, 0, count + len);
+        cb_count_add(cb, len);
+        if (cb->file) {
+            cb_file_write_end(cb, len);    // free space only: nothing to fence off
+        }
+        ret = (int)len;
+    }
+    if (cb->mode == CB_MODE_BLOCKING) {
+        cb_wake_locked(cb);
+        pthread_mutex_unlock(&cb->lock);
+    }
+    return ret;
+}
+
+/* One readv() from fd into the free space. Returns bytes read, 0 at EOF,
+ * -1 with errno (ENOBUFS when the buffer is full). */
+ssize_t cb_read_from_fd(CircularBuffer* cb, int fd) {
+    CbMutSpan span[2];
+    if (!cb) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (cb_reserve(cb, span) == 0) {
+        errno = ENOBUFS;
+        return -1;
+    }
+    struct iovec iov[2] = {
+        { span[0].data, span[0].len },
+        { span[1].data, span[1].len },
+    };
+    ssize_t n = readv(fd, iov, span[1].len ? 2 : 1);
+    if (n > 0) {
+        cb_commit(cb, (size_t)n);
+    }
+    return n;
+}
+
+/* One writev() of the stored bytes to fd; consumes what was written.
+ * Returns bytes written (0 when empty) or -1 with errno. */
+ssize_t cb_write_to_fd(CircularBuffer* cb, int fd) {
+    CbSpan span[2];
+    if (!cb) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (cb_peek(cb, span) == 0) {
+        return 0;
+    }
+    struct iovec iov[2] = {
+        { (void*)span[0].data, span[0].len },
+        { (void*)span[1].data, span[1].len },
+    };
+    ssize_t n = writev(fd, iov, span[1].len ? 2 : 1);
+    if (n > 0) {
+        cb_consume(cb, (size_t)n);
     }
-    return read; // may be 0 if empty
+    return n;
 }
 
 size_t cb_available(const CircularBuffer* cb) {
     if (!cb) return 0;
-    return cb->size - cb->count;
+    return cb->size - cb_count(cb);
 }
 
 int cb_clear_overflow(CircularBuffer* cb) {
     if (!cb) return 0;
-    int prev = cb->overflow_occurred;
-    cb->overflow_occurred = 0;
-    return prev;
+    if (cb->file) {
+        atomic_store_explicit(&cb->file->overflow, 0, memory_order_relaxed);
+    }
+    return atomic_exchange_explicit(&cb->overflow_occurred, 0, memory_order_relaxed);
+}
+
+/* bytes_read is loaded before count and bytes_written: whatever the reader
+ * had taken was written before, so even a snapshot taken next to a running
+ * SPSC pair never shows more read than written. */
+void cb_stats(const CircularBuffer* cb, CbStats* out) {
+    if (!cb || !out) return;
+    CircularBuffer* m = (CircularBuffer*)cb;
+    if (cb->mode == CB_MODE_BLOCKING) {
+        pthread_mutex_lock(&m->lock);
+    }
+    out->bytes_read = atomic_load_explicit(&cb->bytes_read, memory_order_acquire);
+    out->stored = cb_count(cb);
+    out->bytes_written = atomic_load_explicit(&cb->bytes_written, memory_order_acquire);
+    out->bytes_overwritten = atomic_load_explicit(&cb->bytes_overwritten, memory_order_relaxed);
+    out->overflow_events = atomic_load_explicit(&cb->overflow_events, memory_order_relaxed);
+    out->peak = atomic_load_explicit(&cb->peak, memory_order_relaxed);
+    out->capacity = cb->size;
+    if (cb->mode == CB_MODE_BLOCKING) {
+        pthread_mutex_unlock(&m->lock);
+    }
+}
+
+/* Map path (created if missing) as header page + size data bytes. An
+ * existing file must have been created with the same size (or pass 0 to
+ * take its size); its contents are recovered: whatever a writer killed
+ * mid-write was touching is dropped, the rest is kept in order. */
+CircularBuffer* cb_open_file(const char* path, size_t size) {
+    if (!path) {
+        errno = EINVAL;
+        return NULL;
+    }
+    long page = sysconf(_SC_PAGESIZE);
+    size_t data_offset = page > 0 && (size_t)page >= sizeof(CbFileHeader) ? (size_t)page : 4096;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+    int fresh = st.st_size == 0;
+    if (size == 0 && !fresh && (size_t)st.st_size > data_offset) {
+        size = (size_t)st.st_size - data_offset;   // adopt the existing size
+    }
+    size_t file_len = data_offset + size;
+    if (size == 0) {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+    if (fresh && ftruncate(fd, (off_t)file_len) != 0) {
+        close(fd);
+        return NULL;
+    }
+    if (!fresh && (size_t)st.st_size != file_len) {
+        close(fd);
+        errno = EINVAL;    // made for another size: leave it alone
+        return NULL;
+    }
+    void* map = mmap(NULL, file_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+    CbFileHeader* f = map;
+    if (!fresh && f->magic == 0) {
+        fresh = 1;    // the creator died before finishing the header
+    }
+    if (!fresh && (f->magic != CB_FILE_MAGIC || f->size != size || f->data_offset != data_offset)) {
+        munmap(map, file_len);
+        errno = EINVAL;
+        return NULL;
+    }
+    CircularBuffer* cb = cb_alloc(0);
+    if (!cb) {
+        munmap(map, file_len);
+        return NULL;
+    }
+    cb_setup(cb, (uint8_t*)map + data_offset, size);
+    cb->heap = 1;
+    cb->file = f;
+    cb->file_len = file_len;
+
+    if (fresh) {
+        f->size = size;
+        f->data_offset = data_offset;
+        atomic_init(&f->head_pos, 0);
+        atomic_init(&f->tail_pos, 0);
+        atomic_init(&f->pending, 0);
+        atomic_init(&f->overflow, 0);
+        f->magic = CB_FILE_MAGIC;    // last: a half-made header is rejected
+        return cb;
+    }
+
+    // recover: drop what an interrupted write may have overwritten
+    uint64_t head = atomic_load(&f->head_pos);
+    uint64_t tail = atomic_load(&f->tail_pos);
+    uint64_t pending = atomic_load(&f->pending);
+    if (pending > size && pending - size > tail) tail = pending - size;
+    if (tail > head) tail = head;
+    atomic_store(&f->tail_pos, tail);
+    atomic_store(&f->pending, head);
+
+    cb->head = (size_t)(head % size);
+    cb->tail = (size_t)(tail % size);
+    atomic_store(&cb->count, (size_t)(head - tail));
+    atomic_store(&cb->overflow_occurred, atomic_load(&f->overflow));
+    // counters are per process: the recovered bytes count as written here
+    atomic_store(&cb->bytes_written, head - tail);
+    atomic_store(&cb->peak, (size_t)(head - tail));
+    return cb;
+}
+
+uint64_t cb_file_offset(const CircularBuffer* cb) {
+    if (!cb || !cb->file) return 0;
+    return atomic_load_explicit(&cb->file->tail_pos, memory_order_relaxed);
+}
+
+int cb_sync(CircularBuffer* cb) {
+    if (!cb || !cb->file) {
+        return -1;
+    }
+    return msync(cb->file, cb->file_len, MS_SYNC);
 }
@@ -2,6 +2,7 @@
 #pragma once
 #include <stddef.h>
 #include <stdint.h>
+#include <sys/types.h> // ssize_t
 
 #ifdef __cplusplus
 extern "C" {
@@ -9,10 +10,87 @@ extern "C" {
 
 typedef struct CircularBuffer CircularBuffer;
 
+/* Room and alignment the (opaque) struct needs in caller memory, see
+ * cb_init. Checked against the real struct at compile time. */
+#define CB_OBJECT_SIZE  512
+#define CB_OBJECT_ALIGN 64
+
+#ifdef __cplusplus
+#define CB_ALIGNAS(n) alignas(n)
+#else
+#define CB_ALIGNAS(n) _Alignas(n)
+#endif
+
+/* Struct and data side by side, for a static, global or embedded buffer:
+ *     static CB_STORAGE(log, 4096);
+ *     CircularBuffer* cb = cb_init(log.object, log.data, sizeof log.data);
+ */
+#define CB_STORAGE(name, bytes)                                           \
+    struct {                                                              \
+        CB_ALIGNAS(CB_OBJECT_ALIGN) unsigned char object[CB_OBJECT_SIZE]; \
+        uint8_t data[bytes];                                              \
+    } name
+
+/* How the buffer may be shared between threads, fixed at creation.
+ * CB_MODE_PLAIN     no synchronization (one thread, or an external lock).
+ * CB_MODE_SPSC      lock-free for one writer thread and one reader thread.
+ *                   The writer cannot evict unread bytes, so cb_write
+ *                   stores what fits, drops the rest and sets the overflow
+ *                   flag instead of overwriting.
+ * CB_MODE_BLOCKING  mutex + condvars; adds cb_write_wait/cb_read_timeout.
+ *                   cb_write still overwrites; cb_write_wait never does. */
+typedef enum {
+    CB_MODE_PLAIN,
+    CB_MODE_SPSC,
+    CB_MODE_BLOCKING,
+} CbMode;
+
+/* A contiguous run of bytes inside the buffer. */
+typedef struct { const uint8_t* data; size_t len; } CbSpan;
+typedef struct { uint8_t* data; size_t len; } CbMutSpan;
+
+/* Cumulative counters since creation (see cb_stats). In plain and blocking
+ * mode bytes_written - bytes_read - bytes_overwritten == stored. */
+typedef struct {
+    uint64_t bytes_written;      // accepted by writes and commits
+    uint64_t bytes_read;         // read or consumed
+    uint64_t bytes_overwritten;  // lost to overflow: evicted unread (SPSC: newest bytes dropped)
+    uint64_t overflow_events;    // writes that lost data
+    size_t   stored;             // bytes waiting now: how far the reader lags
+    size_t   peak;               // highest stored after any write
+    size_t   capacity;
+} CbStats;
+
 /* Lifecycle */
 CircularBuffer* cb_create(size_t size);
 void            cb_destroy(CircularBuffer* cb);
 
+/* No allocation: the struct goes in mem (CB_OBJECT_SIZE bytes aligned to
+ * CB_OBJECT_ALIGN), the data in storage. Plain mode. cb_destroy on it
+ * frees nothing. Returns mem as a CircularBuffer*, NULL on bad arguments. */
+CircularBuffer* cb_init(void* mem, uint8_t* storage, size_t size);
+
+/* Same, with the storage mapped twice back to back (Linux, memfd) so every
+ * stored region is contiguous. size must be a multiple of the page size;
+ * otherwise (or off Linux) this returns a plain cb_create buffer. */
+CircularBuffer* cb_create_mirrored(size_t size);
+int             cb_is_mirrored(const CircularBuffer* cb);
+
+CircularBuffer* cb_create_mode(size_t size, CbMode mode);     // NULL on error
+CbMode          cb_mode(const CircularBuffer* cb);
+
+/* Persistent buffer: header and data live in a MAP_SHARED mapping of path
+ * (created if missing, one header page + size bytes). Writes stay plain
+ * memory stores; the kernel keeps the pages when the process dies, and
+ * reopening the file recovers the contents. Bytes an interrupted write
+ * may have overwritten are dropped; what is left is intact and in order.
+ * Plain mode only. Reopening with a different size fails with EINVAL;
+ * size 0 opens an existing file at whatever size it was made with.
+ * Returns NULL with errno on error. */
+CircularBuffer* cb_open_file(const char* path, size_t size);
+uint64_t        cb_file_offset(const CircularBuffer* cb); // stream offset of the oldest stored byte
+int             cb_sync(CircularBuffer* cb);              // msync, for power-loss durability; 0 or -1
+
 /* State checks */
 int     cb_is_full(const CircularBuffer* cb);
 int     cb_is_empty(const CircularBuffer* cb);
@@ -21,10 +99,47 @@ int     cb_is_empty(const CircularBuffer* cb);
 int     cb_write(CircularBuffer* cb, const uint8_t* data, size_t len); // returns bytes written or -1
 int     cb_read (CircularBuffer* cb, uint8_t* out, size_t len);        // returns bytes read or -1
 
+/* CB_MODE_BLOCKING only (-1 otherwise). timeout_ms < 0 waits forever.
+ * cb_write_wait writes all of data, sleeping while the buffer is full, and
+ * returns the bytes written (fewer on timeout). cb_read_timeout sleeps
+ * until len bytes (capped at the capacity) are stored, then reads up to
+ * len; on timeout it returns what is there, possibly 0. Waiters are woken
+ * once per batch, not per byte. */
+int     cb_write_wait(CircularBuffer* cb, const uint8_t* data, size_t len, int timeout_ms);
+int     cb_read_timeout(CircularBuffer* cb, uint8_t* out, size_t len, int timeout_ms);
+
+/* Zero-copy read: pointer to the oldest byte, *len = contiguous bytes there
+ * (everything stored, when mirrored). Release them with cb_consume. */
+const uint8_t* cb_data(const CircularBuffer* cb, size_t* len);
+int     cb_consume(CircularBuffer* cb, size_t len);                    // returns bytes dropped or -1
+
+/* Zero-copy spans. span[1] is empty unless the region wraps (never when
+ * mirrored). cb_peek: stored bytes, oldest first, release with cb_consume.
+ * cb_reserve: free space, fill it and publish with cb_commit. Both return
+ * the total length. Reserve/commit never overwrites. Safe from the two
+ * sides of an SPSC buffer; on a blocking buffer do not mix them with an
+ * overwriting cb_write. */
+size_t  cb_peek(const CircularBuffer* cb, CbSpan span[2]);
+size_t  cb_reserve(CircularBuffer* cb, CbMutSpan span[2]);
+int     cb_commit(CircularBuffer* cb, size_t len);                     // returns len, -1 if > free space
+
+/* fd I/O straight to/from the spans: one readv/writev per call, the kernel
+ * does the only copy. read_from_fd returns bytes read, 0 at EOF, -1 with
+ * errno (ENOBUFS when full); write_to_fd consumes what was written and
+ * returns it (0 when empty), or -1 with errno. */
+ssize_t cb_read_from_fd(CircularBuffer* cb, int fd);
+ssize_t cb_write_to_fd(CircularBuffer* cb, int fd);
+
 /* Introspection */
 size_t  cb_available(const CircularBuffer* cb); // free capacity
 int     cb_clear_overflow(CircularBuffer* cb);  // returns previous flag and clears
 
+/* Snapshot of the counters. Writes pay a few plain stores for them, no
+ * locked instructions. Consistent in plain mode and under the lock in
+ * blocking mode; in SPSC mode it may run beside both sides and never shows
+ * bytes_read above bytes_written. */
+void    cb_stats(const CircularBuffer* cb, CbStats* out);
+
 #ifdef __cplusplus
 }
 #endif
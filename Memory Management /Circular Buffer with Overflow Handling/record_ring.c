@@ -0,0 +1,224 @@
+// record_ring.c
+#include "record_ring.h"
+#include <stdlib.h> // malloc, free
+#include <string.h> // memcpy
+
+#define RR_PAD UINT32_MAX   // header length of a lap-skip marker
+
+typedef struct {
+    uint32_t len;
+    uint32_t seq;
+} RrHeader;
+
+_Static_assert(sizeof(RrHeader) == RR_HDR, "record header size");
+_Static_assert(RR_HDR % RR_ALIGN == 0, "payload alignment");
+
+/* head and tail are free-running byte offsets; & mask gives the index.
+ * Entries start on RR_ALIGN boundaries, so a non-empty gap before the end
+ * of the storage always has room for a pad header. */
+struct RecordRing {
+    uint8_t* data;
+    size_t   capacity;       // power of two
+    size_t   mask;
+    uint64_t head;           // next entry goes here
+    uint64_t tail;           // oldest entry (maybe a pad)
+    size_t   reserved;       // payload length of the open reservation
+    int      reserving;
+    uint32_t seq;            // sequence number of the next record
+    uint64_t records;
+    uint64_t records_written;
+    uint64_t bytes_written;
+    uint64_t records_dropped;
+    uint64_t bytes_dropped;
+};
+
+static inline size_t rr_entry(size_t len) {
+    return (RR_HDR + len + RR_ALIGN - 1) & ~(size_t)(RR_ALIGN - 1);
+}
+
+static inline RrHeader* rr_hdr(const RecordRing* rr, size_t idx) {
+    return (RrHeader*)(void*)(rr->data + idx);
+}
+
+RecordRing* rr_create(size_t capacity) {
+    size_t cap = 64;
+    while (cap < capacity) {
+        if (cap > SIZE_MAX / 2) return NULL;
+        cap <<= 1;
+    }
+    RecordRing* rr = calloc(1, sizeof(*rr));
+    if (!rr) {
+        return NULL;
+    }
+    // malloc alignment covers RR_ALIGN, so every entry is aligned too
+    rr->data = malloc(cap);
+    if (!rr->data) {
+        free(rr);
+        return NULL;
+    }
+    rr->capacity = cap;
+    rr->mask = cap - 1;
+    return rr;
+}
+
+void rr_destroy(RecordRing* rr) {
+    if (rr) {
+        free(rr->data);
+        free(rr);
+    }
+}
+
+/* One record may fill the whole storage; the length must also fit the
+ * 32-bit header and stay clear of the pad marker. */
+static inline size_t rr_max_len(const RecordRing* rr) {
+    size_t max = rr->capacity - RR_HDR;
+    return max < RR_PAD ? max : RR_PAD - 1;
+}
+
+size_t rr_max_record(const RecordRing* rr) {
+    if (!rr) return 0;
+    return rr_max_len(rr);
+}
+
+/* Drop the oldest entry: a pad, or a record nobody read. */
+static void rr_evict(RecordRing* rr) {
+    size_t idx = rr->tail & rr->mask;
+    uint32_t len = rr_hdr(rr, idx)->len;
+    if (len == RR_PAD) {
+        rr->tail += rr->capacity - idx;
+        return;
+    }
+    rr->tail += rr_entry(len);
+    rr->records--;
+    rr->records_dropped++;
+    rr->bytes_dropped += len;
+}
+
+void* rr_reserve(RecordRing* rr, size_t len) {
+    if (!rr || len > rr_max_len(rr)) {
+        return NULL;
+    }
+    size_t need = rr_entry(len);
+    size_t idx = rr->head & rr->mask;
+    size_t pad = rr->capacity - idx < need ? rr->capacity - idx : 0;
+
+    while (rr->capacity - (size_t)(rr->head - rr->tail) < pad + need) {
+        if (rr->head == rr->tail) {
+            // empty: start the next lap directly instead of padding
+            rr->head += pad;
+            rr->tail = rr->head;
+            pad = 0;
+            break;
+        }
+        rr_evict(rr);
+    }
+    if (pad) {
+        rr_hdr(rr, idx)->len = RR_PAD;
+        rr->head += pad;
+    }
+    rr->reserved = len;
+    rr->reserving = 1;
+    return rr->data + (rr->head & rr->mask) + RR_HDR;
+}
+
+int rr_commit(RecordRing* rr, size_t len) {
+    if (!rr || !rr->reserving || len > rr->reserved) {
+        return -1;
+    }
+    RrHeader* h = rr_hdr(rr, rr->head & rr->mask);
+    h->len = (uint32_t)len;
+    h->seq = rr->seq++;
+    rr->head += rr_entry(len);
+    rr->reserving = 0;
+    rr->records++;
+    rr->records_written++;
+    rr->bytes_written += len;
+    return 0;
+}
+
+int rr_write(RecordRing* rr, const void* data, size_t len) {
+    void* p = rr_reserve(rr, len);
+    if (!p || (!data && len)) {
+        return -1;
+    }
+    memcpy(p, data, len);
+    return rr_commit(rr, len);
+}
+
+/* Offset of the first record at or after pos, skipping a pad; head if none. */
+static uint64_t rr_skip_pad(const RecordRing* rr, uint64_t pos) {
+    if (pos != rr->head) {
+        size_t idx = pos & rr->mask;
+        if (rr_hdr(rr, idx)->len == RR_PAD) {
+            pos += rr->capacity - idx;
+        }
+    }
+    return pos;
+}
+
+const void* rr_peek(const RecordRing* rr, size_t* len) {
+    RrIter it;
+    rr_iter_begin(rr, &it);
+    return rr_iter_next(rr, &it, len);
+}
+
+int rr_pop(RecordRing* rr) {
+    if (!rr) {
+        return -1;
+    }
+    rr->tail = rr_skip_pad(rr, rr->tail);
+    if (rr->tail == rr->head) {
+        return -1;
+    }
+    rr->tail += rr_entry(rr_hdr(rr, rr->tail & rr->mask)->len);
+    rr->records--;
+    return 0;
+}
+
+int rr_read(RecordRing* rr, void* out, size_t cap) {
+    size_t len;
+    const void* p = rr_peek(rr, &len);
+    if (!p) {
+        return 0;
+    }
+    if (!out || len > cap) {
+        return -1;
+    }
+    memcpy(out, p, len);
+    rr_pop(rr);
+    return (int)len;
+}
+
+void rr_iter_begin(const RecordRing* rr, RrIter* it) {
+    if (it) it->pos = rr ? rr->tail : 0;
+}
+
+const void* rr_iter_next(const RecordRing* rr, RrIter* it, size_t* len) {
+    if (!rr || !it) {
+        return NULL;
+    }
+    uint64_t pos = rr_skip_pad(rr, it->pos);
+    if (pos == rr->head) {
+        it->pos = pos;
+        return NULL;
+    }
+    const RrHeader* h = rr_hdr(rr, pos & rr->mask);
+    if (len) *len = h->len;
+    it->pos = pos + rr_entry(h->len);
+    return h + 1;
+}
+
+uint32_t rr_record_seq(const void* payload) {
+    return ((const RrHeader*)payload - 1)->seq;
+}
+
+void rr_stats(const RecordRing* rr, RrStats* out) {
+    if (!rr || !out) return;
+    out->records_written = rr->records_written;
+    out->bytes_written = rr->bytes_written;
+    out->records_dropped = rr->records_dropped;
+    out->bytes_dropped = rr->bytes_dropped;
+    out->records = rr->records;
+    out->used = (size_t)(rr->head - rr->tail);
+    out->capacity = rr->capacity;
+}
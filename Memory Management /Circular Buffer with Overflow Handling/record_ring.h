@@ -0,0 +1,77 @@
+// record_ring.h
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Variable-length record ring on top of the same overwrite-oldest idea as
+ * CircularBuffer, but overflow evicts whole records, so a reader always
+ * starts at a record boundary. Meant as an in-process flight recorder:
+ * one thread writes and reads (or reads after the fact).
+ *
+ * Layout: each record is an RR_HDR-byte header (payload length, sequence
+ * number) followed by the payload, padded to RR_ALIGN bytes. A record
+ * never wraps: when it does not fit before the end of the storage, the
+ * rest of the lap is skipped with a pad marker. Payload pointers are
+ * RR_ALIGN-aligned, so records can hold plain structs. */
+
+#define RR_ALIGN 8u
+#define RR_HDR   8u
+
+typedef struct RecordRing RecordRing;
+
+typedef struct {
+    uint64_t records_written;
+    uint64_t bytes_written;     // payload bytes
+    uint64_t records_dropped;   // evicted unread to make room
+    uint64_t bytes_dropped;     // payload bytes of those
+    uint64_t records;           // stored now
+    size_t   used;              // storage bytes in use, headers and padding included
+    size_t   capacity;
+} RrStats;
+
+/* Read cursor for rr_iter_next; only valid until the next write. */
+typedef struct {
+    uint64_t pos;
+} RrIter;
+
+/* Lifecycle. The capacity is rounded up to a power of two (>= 64).
+ * Returns NULL on error. */
+RecordRing* rr_create(size_t capacity);
+void        rr_destroy(RecordRing* rr);
+
+/* Largest payload a single record can carry. */
+size_t      rr_max_record(const RecordRing* rr);
+
+/* Writes. rr_reserve evicts the oldest records until len fits and returns
+ * where to put the payload (NULL if len > rr_max_record). Nothing is
+ * visible until rr_commit, which may shrink the record to len <= the
+ * reserved length. rr_write = reserve + memcpy + commit; returns 0 or -1. */
+void*       rr_reserve(RecordRing* rr, size_t len);
+int         rr_commit(RecordRing* rr, size_t len);
+int         rr_write(RecordRing* rr, const void* data, size_t len);
+
+/* Reads, oldest first. rr_peek points at the payload in place (NULL when
+ * empty); rr_pop drops that record. rr_read copies it out and pops it;
+ * returns its length, 0 when empty, -1 if out is too small (nothing popped). */
+const void* rr_peek(const RecordRing* rr, size_t* len);
+int         rr_pop(RecordRing* rr);
+int         rr_read(RecordRing* rr, void* out, size_t cap);
+
+/* Walk the stored records without consuming them. */
+void        rr_iter_begin(const RecordRing* rr, RrIter* it);
+const void* rr_iter_next(const RecordRing* rr, RrIter* it, size_t* len);
+
+/* Sequence number of a record (counts every committed record, dropped or
+ * not, mod 2^32): gaps between consecutive reads show what was evicted.
+ * payload must come from rr_peek or rr_iter_next. */
+uint32_t    rr_record_seq(const void* payload);
+
+void        rr_stats(const RecordRing* rr, RrStats* out);
+
+#ifdef __cplusplus
+}
+#endif
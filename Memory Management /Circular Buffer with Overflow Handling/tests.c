@@ -1,8 +1,19 @@
 // tests.c - simple acceptance tests using assert
+#define _POSIX_C_SOURCE 200809L // pipe, sched_yield, mkstemp, kill
 #include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include "circular_buffer.h"
+#include "record_ring.h"
 
 #define ASSERT_TRUE(x)  assert((x))
 #define ASSERT_EQ(a,b)  assert((a) == (b))
@@ -76,10 +87,516 @@ static void test_len_gt_capacity(void) {
     cb_destroy(cb);
 }
 
+/* Reference model: the original byte-at-a-time implementation, kept to
+ * check the segment-copy version against. */
+#define REF_MAX 65536 // a page multiple for 4K, 16K and 64K pages
+
+typedef struct {
+    uint8_t buffer[REF_MAX];
+    size_t  size, head, tail, count;
+    int     overflow_occurred;
+} RefBuffer;
+
+static int ref_write(RefBuffer* rb, const uint8_t* data, size_t len) {
+    int written = 0;
+    for (size_t i = 0; i < len; ++i) {
+        if (rb->count == rb->size) {
+            rb->overflow_occurred = 1;
+            rb->tail = (rb->tail + 1) % rb->size;
+        } else {
+            rb->count++;
+        }
+        rb->buffer[rb->head] = data[i];
+        rb->head = (rb->head + 1) % rb->size;
+        written++;
+    }
+    return written;
+}
+
+static int ref_read(RefBuffer* rb, uint8_t* out, size_t len) {
+    int read = 0;
+    while (len > 0 && rb->count > 0) {
+        out[read] = rb->buffer[rb->tail];
+        rb->tail = (rb->tail + 1) % rb->size;
+        rb->count--;
+        read++;
+        len--;
+    }
+    return read;
+}
+
+/* Drive cb and the reference model with the same random operations. */
+static void differential_run(CircularBuffer* cb, size_t size, int ops) {
+    static uint8_t in[3 * REF_MAX], out[3 * REF_MAX], exp[3 * REF_MAX];
+    static RefBuffer ref;
+    memset(&ref, 0, sizeof ref);
+    ref.size = size;
+
+    for (int op = 0; op < ops; ++op) {
+        // mostly short ops, sometimes longer than the capacity
+        size_t len = (size_t)rand() % (rand() % 8 ? size + 1 : 3 * size + 1);
+        switch (rand() % 7) {
+        case 0: case 1:
+            for (size_t i = 0; i < len; ++i) in[i] = (uint8_t)rand();
+            ASSERT_EQ(cb_write(cb, in, len), ref_write(&ref, in, len));
+            break;
+        case 2: case 3: {
+            int n = cb_read(cb, out, len);
+            ASSERT_EQ(n, ref_read(&ref, exp, len));
+            ASSERT_MEMEQ(out, exp, (size_t)n);
+            break;
+        }
+        case 4: {
+            // zero-copy path: look at the contiguous run, then drop it
+            size_t n;
+            const uint8_t* p = cb_data(cb, &n);
+            if (n > len) n = len;
+            ASSERT_EQ(ref_read(&ref, exp, n), (int)n);
+            ASSERT_MEMEQ(p, exp, n);
+            ASSERT_EQ(cb_consume(cb, n), (int)n);
+            break;
+        }
+        case 5: {
+            // reserve/commit never overwrites: fill at most the free space
+            CbMutSpan span[2];
+            size_t n = cb_reserve(cb, span);
+            if (n > len) n = len;
+            for (size_t i = 0; i < n; ++i) in[i] = (uint8_t)rand();
+            size_t first = n < span[0].len ? n : span[0].len;
+            memcpy(span[0].data, in, first);
+            memcpy(span[1].data, in + first, n - first);
+            ASSERT_EQ(cb_commit(cb, n), (int)n);
+            ASSERT_EQ(ref_write(&ref, in, n), (int)n);
+            break;
+        }
+        default:
+            ASSERT_EQ(cb_clear_overflow(cb), ref.overflow_occurred);
+            ref.overflow_occurred = 0;
+            break;
+        }
+        ASSERT_EQ(cb_available(cb), ref.size - ref.count);
+        ASSERT_EQ(cb_is_full(cb), ref.count == ref.size);
+        ASSERT_EQ(cb_is_empty(cb), ref.count == 0);
+        CbStats st;
+        cb_stats(cb, &st);
+        ASSERT_EQ(st.stored, ref.count);
+        ASSERT_EQ(st.bytes_written - st.bytes_read - st.bytes_overwritten, ref.count);
+        ASSERT_TRUE(st.peak >= st.stored && st.peak <= size);
+    }
+}
+
+static void test_differential_random(void) {
+    static const size_t sizes[] = {1, 2, 3, 7, 16, 64, 100, 128, 257, 512};
+    srand(12345);
+    for (size_t s = 0; s < sizeof sizes / sizeof sizes[0]; ++s) {
+        CircularBuffer* cb = cb_create(sizes[s]);
+        ASSERT_TRUE(cb);
+        differential_run(cb, sizes[s], 20000);
+        cb_destroy(cb);
+    }
+}
+
+static void test_mirrored(void) {
+    // not a page multiple: plain buffer, same behaviour
+    CircularBuffer* cb = cb_create_mirrored(100);
+    ASSERT_TRUE(cb);
+    ASSERT_TRUE(!cb_is_mirrored(cb));
+    differential_run(cb, 100, 5000);
+    cb_destroy(cb);
+
+    cb = cb_create_mirrored(REF_MAX);
+    ASSERT_TRUE(cb);
+#ifdef __linux__
+    ASSERT_TRUE(cb_is_mirrored(cb));
+#endif
+    // a run across the end of the storage reads back as one span
+    static uint8_t fill[REF_MAX];
+    memset(fill, 1, sizeof fill);
+    ASSERT_EQ(cb_write(cb, fill, REF_MAX - 10), REF_MAX - 10);
+    ASSERT_EQ(cb_consume(cb, REF_MAX - 10), REF_MAX - 10);
+    uint8_t in[32];
+    for (int i = 0; i < 32; ++i) in[i] = (uint8_t)i;
+    ASSERT_EQ(cb_write(cb, in, 32), 32);
+    size_t n;
+    const uint8_t* p = cb_data(cb, &n);
+    ASSERT_EQ(n, cb_is_mirrored(cb) ? 32u : 10u);
+    ASSERT_MEMEQ(p, in, n);
+    ASSERT_EQ(cb_consume(cb, 32), 32);
+
+    differential_run(cb, REF_MAX, 500);
+    cb_destroy(cb);
+}
+
+static void test_spans_and_fd(void) {
+    CircularBuffer* cb = cb_create(8);
+    ASSERT_TRUE(cb);
+    uint8_t a[] = {1,2,3,4,5,6};
+    ASSERT_EQ(cb_write(cb, a, 6), 6);
+    uint8_t tmp[4];
+    ASSERT_EQ(cb_read(cb, tmp, 4), 4);
+
+    // free space wraps: 2 bytes at the end, 4 at the start
+    CbMutSpan w[2];
+    ASSERT_EQ(cb_reserve(cb, w), 6);
+    ASSERT_EQ(w[0].len, 2);
+    ASSERT_EQ(w[1].len, 4);
+    ASSERT_EQ(cb_commit(cb, 7), -1);
+    memcpy(w[0].data, "\x07\x08", 2);
+    memcpy(w[1].data, "\x09", 1);
+    ASSERT_EQ(cb_commit(cb, 3), 3);
+
+    CbSpan r[2];
+    ASSERT_EQ(cb_peek(cb, r), 5);
+    ASSERT_EQ(r[0].len, 4);
+    ASSERT_EQ(r[1].len, 1);
+    uint8_t exp[] = {5,6,7,8,9};
+    ASSERT_MEMEQ(r[0].data, exp, 4);
+    ASSERT_MEMEQ(r[1].data, exp + 4, 1);
+    ASSERT_EQ(cb_available(cb), 3);     // peek did not consume
+
+    // out through a pipe with writev, back in with readv across the wrap
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    ASSERT_EQ(cb_write_to_fd(cb, fds[1]), 5);
+    ASSERT_TRUE(cb_is_empty(cb));
+    ASSERT_EQ(cb_write_to_fd(cb, fds[1]), 0);
+    ASSERT_EQ(cb_write(cb, a, 6), 6);   // head is now mid-buffer
+    ASSERT_EQ(cb_read_from_fd(cb, fds[0]), 2);      // only 2 free
+    ASSERT_EQ(cb_read_from_fd(cb, fds[0]), -1);
+    ASSERT_EQ(errno, ENOBUFS);
+    ASSERT_EQ(cb_consume(cb, 6), 6);
+    ASSERT_EQ(cb_read_from_fd(cb, fds[0]), 3);
+    uint8_t out[5];
+    ASSERT_EQ(cb_read(cb, out, 5), 5);
+    ASSERT_MEMEQ(out, exp, 5);
+    close(fds[1]);
+    ASSERT_EQ(cb_read_from_fd(cb, fds[0]), 0);      // EOF
+    close(fds[0]);
+    cb_destroy(cb);
+}
+
+static void test_spsc_drops_instead_of_overwriting(void) {
+    CircularBuffer* cb = cb_create_mode(4, CB_MODE_SPSC);
+    ASSERT_TRUE(cb);
+    ASSERT_EQ(cb_mode(cb), CB_MODE_SPSC);
+    ASSERT_EQ(cb_write_wait(cb, (const uint8_t*)"x", 1, 0), -1);   // blocking mode only
+
+    uint8_t in[] = {1,2,3,4,5,6};
+    ASSERT_EQ(cb_write(cb, in, 6), 4);      // keeps the oldest, drops 5,6
+    ASSERT_EQ(cb_clear_overflow(cb), 1);
+    uint8_t out[4];
+    ASSERT_EQ(cb_read(cb, out, 4), 4);
+    ASSERT_MEMEQ(out, in, 4);
+    cb_destroy(cb);
+}
+
+#define STREAM_BYTES (4u * 1024u * 1024u)
+
+/* Producer thread: a counting pattern in odd-sized chunks. */
+static void* stream_writer(void* arg) {
+    CircularBuffer* cb = arg;
+    uint8_t chunk[777];
+    uint8_t next = 0;
+    for (size_t sent = 0; sent < STREAM_BYTES; ) {
+        size_t n = STREAM_BYTES - sent < sizeof chunk ? STREAM_BYTES - sent : sizeof chunk;
+        for (size_t i = 0; i < n; ++i) chunk[i] = next++;
+        if (cb_mode(cb) == CB_MODE_BLOCKING) {
+            ASSERT_EQ(cb_write_wait(cb, chunk, n, -1), (int)n);
+        } else {
+            for (size_t off = 0; off < n; ) {
+                int w = cb_write(cb, chunk + off, n - off);
+                if (w == 0) sched_yield();  // full: let the reader run
+                off += (size_t)w;
+            }
+        }
+        sent += n;
+    }
+    return NULL;
+}
+
+static void stream_check(CbMode mode, size_t size) {
+    CircularBuffer* cb = cb_create_mode(size, mode);
+    ASSERT_TRUE(cb);
+    pthread_t t;
+    ASSERT_EQ(pthread_create(&t, NULL, stream_writer, cb), 0);
+    uint8_t buf[500];
+    uint8_t expect = 0;
+    for (size_t got = 0; got < STREAM_BYTES; ) {
+        int n = mode == CB_MODE_BLOCKING ? cb_read_timeout(cb, buf, sizeof buf, 100)
+                                         : cb_read(cb, buf, sizeof buf);
+        ASSERT_TRUE(n >= 0);
+        if (n == 0) sched_yield();
+        for (int i = 0; i < n; ++i) {
+            ASSERT_EQ(buf[i], expect);
+            expect++;
+        }
+        got += (size_t)n;
+        CbStats st;
+        cb_stats(cb, &st);                  // beside a running writer
+        ASSERT_TRUE(st.bytes_read == got && st.bytes_written >= got);
+    }
+    pthread_join(t, NULL);
+    ASSERT_TRUE(cb_is_empty(cb));
+    CbStats st;
+    cb_stats(cb, &st);
+    ASSERT_EQ(st.bytes_written, STREAM_BYTES);
+    ASSERT_EQ(st.bytes_read, STREAM_BYTES);
+    cb_destroy(cb);
+}
+
+static void test_threaded_modes(void) {
+    stream_check(CB_MODE_SPSC, 64);
+    stream_check(CB_MODE_SPSC, 4096);
+    stream_check(CB_MODE_BLOCKING, 64);
+    stream_check(CB_MODE_BLOCKING, 4096);
+
+    // a read with nothing coming back gives up after its timeout
+    CircularBuffer* cb = cb_create_mode(16, CB_MODE_BLOCKING);
+    ASSERT_TRUE(cb);
+    uint8_t out[8];
+    ASSERT_EQ(cb_read_timeout(cb, out, 8, 10), 0);
+    ASSERT_EQ(cb_write_wait(cb, (const uint8_t*)"abc", 3, 0), 3);
+    ASSERT_EQ(cb_read_timeout(cb, out, 8, 10), 3);   // short batch after the timeout
+    uint8_t big[20] = {0};
+    ASSERT_EQ(cb_write_wait(cb, big, 20, 10), 16);   // never overwrites
+    cb_destroy(cb);
+}
+
+static void test_record_ring_basic(void) {
+    RecordRing* rr = rr_create(100);        // rounds up to 128
+    ASSERT_TRUE(rr);
+    ASSERT_EQ(rr_max_record(rr), 128 - RR_HDR);
+    ASSERT_TRUE(rr_reserve(rr, 129) == NULL);
+    ASSERT_EQ(rr_commit(rr, 0), -1);        // nothing reserved
+
+    ASSERT_EQ(rr_write(rr, "hello", 5), 0);
+    uint8_t* p = rr_reserve(rr, 16);
+    ASSERT_TRUE(p);
+    ASSERT_EQ((uintptr_t)p % RR_ALIGN, 0);
+    memcpy(p, "abc", 3);
+    ASSERT_EQ(rr_commit(rr, 17), -1);       // more than reserved
+    ASSERT_EQ(rr_commit(rr, 3), 0);         // shrink to what was used
+
+    size_t len;
+    RrIter it;
+    rr_iter_begin(rr, &it);
+    const char* r = rr_iter_next(rr, &it, &len);
+    ASSERT_TRUE(r && len == 5 && memcmp(r, "hello", 5) == 0);
+    ASSERT_EQ(rr_record_seq(r), 0);
+    r = rr_iter_next(rr, &it, &len);
+    ASSERT_TRUE(r && len == 3 && memcmp(r, "abc", 3) == 0);
+    ASSERT_EQ(rr_record_seq(r), 1);
+    ASSERT_TRUE(rr_iter_next(rr, &it, &len) == NULL);
+
+    char out[8];
+    ASSERT_EQ(rr_read(rr, out, 4), -1);     // too small: stays queued
+    ASSERT_EQ(rr_read(rr, out, sizeof out), 5);
+    ASSERT_EQ(rr_read(rr, out, sizeof out), 3);
+    ASSERT_EQ(rr_read(rr, out, sizeof out), 0);
+    ASSERT_EQ(rr_pop(rr), -1);
+    rr_destroy(rr);
+}
+
+/* Record n has length n % 61 and bytes (uint8_t)(n + i). */
+static void test_record_ring_evicts_whole_records(void) {
+    RecordRing* rr = rr_create(512);
+    ASSERT_TRUE(rr);
+    uint8_t rec[64], out[64];
+    uint32_t next_write = 0, last_read = 0;
+    uint64_t reads = 0;
+    int have_read = 0;
+    srand(777);
+
+    for (int op = 0; op < 200000; ++op) {
+        if (rand() % 3) {
+            size_t len = next_write % 61;
+            for (size_t i = 0; i < len; ++i) rec[i] = (uint8_t)(next_write + i);
+            ASSERT_EQ(rr_write(rr, rec, len), 0);
+            next_write++;
+            continue;
+        }
+        size_t len;
+        const uint8_t* p = rr_peek(rr, &len);
+        if (!p) continue;
+        uint32_t seq = rr_record_seq(p);
+        // whole, intact records, oldest first; gaps only where evicted
+        ASSERT_TRUE(!have_read || seq > last_read);
+        ASSERT_EQ(len, seq % 61);
+        for (size_t i = 0; i < len; ++i) ASSERT_EQ(p[i], (uint8_t)(seq + i));
+        ASSERT_EQ(rr_read(rr, out, sizeof out), (int)len);
+        last_read = seq;
+        have_read = 1;
+        reads++;
+    }
+
+    RrStats st;
+    rr_stats(rr, &st);
+    ASSERT_EQ(st.records_written, next_write);
+    ASSERT_TRUE(st.records_dropped > 0);
+    ASSERT_EQ(st.records_written, reads + st.records_dropped + st.records);
+    ASSERT_TRUE(st.used <= st.capacity);
+    rr_destroy(rr);
+}
+
+/* File-backed stream test: the byte at stream offset p is p % 251, so the
+ * writer copies straight from a table and spends its time in cb_write,
+ * where the kill is most likely to land. */
+#define FILE_SIZE  (64u * 1024u)
+#define FILE_CHUNK (FILE_SIZE + FILE_SIZE / 2)
+
+static uint8_t stream_table[251 + FILE_CHUNK];
+
+static void file_writer(const char* path, unsigned seed) {
+    CircularBuffer* cb = cb_open_file(path, FILE_SIZE);
+    if (!cb) _exit(1);
+    uint64_t pos = cb_file_offset(cb) + (FILE_SIZE - cb_available(cb));
+    srand(seed);
+    for (;;) {
+        size_t len = 1 + (size_t)rand() % FILE_CHUNK;
+        cb_write(cb, stream_table + pos % 251, len);
+        pos += len;
+        if (rand() % 4 == 0) {
+            cb_consume(cb, (size_t)rand() % FILE_SIZE);
+        }
+    }
+}
+
+static void test_file_survives_kill(void) {
+    char path[] = "/tmp/cb_file_testXXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_TRUE(fd >= 0);
+    close(fd);
+    for (size_t i = 0; i < sizeof stream_table; ++i) stream_table[i] = (uint8_t)(i % 251);
+    static uint8_t out[FILE_SIZE];
+    uint64_t last_end = 0;
+
+    for (int round = 0; round < 50; ++round) {
+        pid_t pid = fork();
+        ASSERT_TRUE(pid >= 0);
+        if (pid == 0) {
+            file_writer(path, (unsigned)round);
+        }
+        struct timespec nap = { 0, 1000000L + (long)(rand() % 5000) * 1000L };
+        nanosleep(&nap, NULL);
+        kill(pid, SIGKILL);
+        int status;
+        waitpid(pid, &status, 0);
+        ASSERT_TRUE(WIFSIGNALED(status));
+
+        // whatever is left must be an intact, in-order piece of the stream
+        CircularBuffer* cb = cb_open_file(path, FILE_SIZE);
+        ASSERT_TRUE(cb);
+        uint64_t first = cb_file_offset(cb);
+        int n = cb_read(cb, out, FILE_SIZE);
+        ASSERT_TRUE(n >= 0 && n <= (int)FILE_SIZE);
+        for (int i = 0; i < n; ++i) ASSERT_EQ(out[i], (first + (uint64_t)i) % 251);
+        ASSERT_TRUE(first + (uint64_t)n >= last_end);   // never goes backwards
+        last_end = first + (uint64_t)n;
+        cb_destroy(cb);
+
+        // the read itself is persistent: the next open starts after it
+        cb = cb_open_file(path, 0);
+        ASSERT_TRUE(cb);
+        ASSERT_EQ(cb_file_offset(cb), last_end);
+        ASSERT_TRUE(cb_is_empty(cb));
+        cb_destroy(cb);
+    }
+    ASSERT_TRUE(last_end > 0);
+
+    ASSERT_TRUE(cb_open_file(path, FILE_SIZE * 2) == NULL);  // wrong size: refused
+    ASSERT_EQ(errno, EINVAL);
+    unlink(path);
+}
+
+static CB_STORAGE(static_cb, 8);
+
+typedef struct {
+    int id;
+    CB_STORAGE(rx, 16);
+} Connection;
+
+static void test_caller_storage(void) {
+    CircularBuffer* cb = cb_init(static_cb.object, static_cb.data, sizeof static_cb.data);
+    ASSERT_TRUE(cb == (CircularBuffer*)(void*)static_cb.object);
+    uint8_t in[] = {1,2,3,4,5,6,7,8,9};
+    ASSERT_EQ(cb_write(cb, in, 9), 9);      // same overwrite semantics
+    ASSERT_EQ(cb_clear_overflow(cb), 1);
+    uint8_t out[8];
+    ASSERT_EQ(cb_read(cb, out, 8), 8);
+    ASSERT_MEMEQ(out, in + 1, 8);
+    cb_destroy(cb);                          // frees nothing (ASan would object)
+
+    Connection conn = { .id = 7 };
+    cb = cb_init(conn.rx.object, conn.rx.data, sizeof conn.rx.data);
+    ASSERT_TRUE(cb);
+    ASSERT_EQ(cb_available(cb), 16);
+    ASSERT_EQ(cb_write(cb, in, 3), 3);
+    ASSERT_EQ(conn.rx.data[2], 3);          // the data really lives in conn
+    cb_destroy(cb);
+    ASSERT_EQ(conn.id, 7);
+
+    ASSERT_TRUE(cb_init(static_cb.object + 1, static_cb.data, 8) == NULL);   // misaligned
+    ASSERT_TRUE(cb_init(static_cb.object, static_cb.data, 0) == NULL);
+    ASSERT_TRUE(cb_init(static_cb.object, NULL, 8) == NULL);
+}
+
+static void test_stats(void) {
+    CircularBuffer* cb = cb_create(8);
+    uint8_t in[20] = {0}, out[20];
+    CbStats st;
+    cb_stats(cb, &st);
+    ASSERT_EQ(st.bytes_written + st.bytes_read + st.overflow_events + st.peak, 0);
+    ASSERT_EQ(st.capacity, 8);
+
+    ASSERT_EQ(cb_write(cb, in, 6), 6);
+    ASSERT_EQ(cb_read(cb, out, 2), 2);
+    ASSERT_EQ(cb_write(cb, in, 7), 7);       // 4 + 7: the 3 oldest go
+    ASSERT_EQ(cb_write(cb, in, 20), 20);     // 8 stored + 12 leading input bytes lost
+    ASSERT_EQ(cb_clear_overflow(cb), 1);     // the flag clears, the counters stay
+    ASSERT_EQ(cb_consume(cb, 5), 5);
+    cb_stats(cb, &st);
+    ASSERT_EQ(st.bytes_written, 33);
+    ASSERT_EQ(st.bytes_read, 7);
+    ASSERT_EQ(st.bytes_overwritten, 3 + 20);
+    ASSERT_EQ(st.overflow_events, 2);
+    ASSERT_EQ(st.stored, 3);
+    ASSERT_EQ(st.peak, 8);
+    cb_destroy(cb);
+
+    // SPSC drops the newest bytes instead, and counts them the same way
+    cb = cb_create_mode(8, CB_MODE_SPSC);
+    ASSERT_EQ(cb_write(cb, in, 5), 5);
+    ASSERT_EQ(cb_write(cb, in, 5), 3);
+    cb_stats(cb, &st);
+    ASSERT_EQ(st.bytes_written, 8);
+    ASSERT_EQ(st.bytes_overwritten, 2);
+    ASSERT_EQ(st.overflow_events, 1);
+    ASSERT_EQ(st.peak, 8);
+    cb_destroy(cb);
+
+    cb = cb_create_mode(8, CB_MODE_BLOCKING);
+    ASSERT_EQ(cb_write_wait(cb, in, 4, 0), 4);
+    ASSERT_EQ(cb_read_timeout(cb, out, 3, 0), 3);
+    cb_stats(cb, &st);
+    ASSERT_EQ(st.bytes_written - st.bytes_read, 1);
+    ASSERT_EQ(st.peak, 4);
+    cb_destroy(cb);
+}
+
 int main(void) {
     test_basic_write_read();
     test_wrap_and_overflow();
     test_partial_read_and_available();
     test_len_gt_capacity();
+    test_differential_random();
+    test_mirrored();
+    test_spans_and_fd();
+    test_spsc_drops_instead_of_overwriting();
+    test_threaded_modes();
+    test_record_ring_basic();
+    test_record_ring_evicts_whole_records();
+    test_file_survives_kill();
+    test_caller_storage();
+    test_stats();
     return 0;
 }
@@ -0,0 +1,187 @@
+// bench_deque.c - deque.c index math and growth against the original
+// modulo implementation, on three steady-state workloads:
+//   queue  push_back + pop_front, length held at half the capacity
+//   stack  bursts of push_back then as many pop_back
+//   mixed  random end for each push and pop (xorshift), length kept in range
+// Deques:
+//   modulo     the original code: (x +- 1 + capacity) % capacity per op
+//   fixed      deque_create(1000): compare-and-subtract wrap
+//   fixed-pow2 deque_create(1024): mask wrap
+//   growable   deque_create_growable(16), doubling up to the working size
+// plus the queue in batches of 64 with deque_push_back_n/deque_pop_front_n.
+// Every run must pop the same values (same sum) as the modulo baseline.
+//
+// usage: bench_deque [million_ops]
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "deque.h"
+
+#define NOINLINE __attribute__((noinline))   // same call cost as deque.c
+
+/* The original implementation, kept here as the baseline. */
+typedef struct {
+    int *data;
+    int head, tail, size, capacity;
+} ModDeque;
+
+static ModDeque* mod_create(int capacity) {
+    ModDeque* dq = malloc(sizeof *dq);
+    dq->data = malloc(sizeof(int) * (size_t)capacity);
+    dq->capacity = capacity;
+    dq->head = dq->tail = dq->size = 0;
+    return dq;
+}
+
+static void mod_destroy(ModDeque* dq) {
+    free(dq->data);
+    free(dq);
+}
+
+static NOINLINE bool mod_push_front(ModDeque* dq, int value) {
+    if (dq->size == dq->capacity) return false;
+    if (dq->size == 0) dq->head = dq->tail = 0;
+    else dq->head = (dq->head - 1 + dq->capacity) % dq->capacity;
+    dq->data[dq->head] = value;
+    dq->size++;
+    return true;
+}
+
+static NOINLINE bool mod_push_back(ModDeque* dq, int value) {
+    if (dq->size == dq->capacity) return false;
+    if (dq->size == 0) dq->head = dq->tail = 0;
+    else dq->tail = (dq->tail + 1) % dq->capacity;
+    dq->data[dq->tail] = value;
+    dq->size++;
+    return true;
+}
+
+static NOINLINE bool mod_pop_front(ModDeque* dq, int* out) {
+    if (dq->size == 0) return false;
+    *out = dq->data[dq->head];
+    if (dq->size == 1) dq->size = 0;
+    else { dq->head = (dq->head + 1) % dq->capacity; dq->size--; }
+    return true;
+}
+
+static NOINLINE bool mod_pop_back(ModDeque* dq, int* out) {
+    if (dq->size == 0) return false;
+    *out = dq->data[dq->tail];
+    if (dq->size == 1) dq->size = 0;
+    else { dq->tail = (dq->tail - 1 + dq->capacity) % dq->capacity; dq->size--; }
+    return true;
+}
+
+typedef enum { WL_QUEUE, WL_STACK, WL_MIXED } Workload;
+
+static const char* const wl_name[] = {"queue", "stack", "mixed"};
+
+#define WORKING 512     // elements the workloads keep around
+#define BURST   64
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static inline uint32_t xorshift(uint32_t* s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+/* One body for both APIs; ops counts pushes plus pops. */
+#define RUN_WORKLOAD(wl, ops, dq, push_front, push_back, pop_front, pop_back, sum) \
+    do {                                                                        \
+        int v_;                                                                 \
+        uint32_t rng_ = 12345;                                                  \
+        for (int i_ = 0; i_ < WORKING; ++i_) push_back(dq, i_);                 \
+        for (uint64_t n_ = 0; n_ < (ops); n_ += 2 * BURST) {                    \
+            for (int k_ = 0; k_ < BURST; ++k_) {                                \
+                switch (wl) {                                                   \
+                case WL_QUEUE:                                                  \
+                    push_back(dq, k_);                                          \
+                    if (pop_front(dq, &v_)) sum += (uint64_t)v_;                \
+                    break;                                                      \
+                case WL_STACK:                                                  \
+                    push_back(dq, k_);                                          \
+                    break;                                                      \
+                case WL_MIXED:                                                  \
+                    if (xorshift(&rng_) & 1) push_front(dq, k_);                \
+                    else push_back(dq, k_);                                     \
+                    if (xorshift(&rng_) & 1) { if (pop_front(dq, &v_)) sum += (uint64_t)v_; } \
+                    else if (pop_back(dq, &v_)) sum += (uint64_t)v_;            \
+                    break;                                                      \
+                }                                                               \
+            }                                                                   \
+            if ((wl) == WL_STACK) {                                             \
+                for (int k_ = 0; k_ < BURST; ++k_) {                            \
+                    if (pop_back(dq, &v_)) sum += (uint64_t)v_;                 \
+                }                                                               \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+static int mismatches;
+
+static void report(const char* name, Workload wl, uint64_t ops, double dt, uint64_t sum,
+                   uint64_t expect) {
+    printf("%-10s %-5s: %6.2f ns/op  (sum %llu)%s\n", name, wl_name[wl], dt * 1e9 / (double)ops,
+           (unsigned long long)sum, sum != expect ? "  MISMATCH" : "");
+    mismatches += sum != expect;
+}
+
+static uint64_t run_modulo(Workload wl, uint64_t ops) {
+    ModDeque* dq = mod_create(1000);
+    uint64_t sum = 0;
+    double t0 = now_sec();
+    RUN_WORKLOAD(wl, ops, dq, mod_push_front, mod_push_back, mod_pop_front, mod_pop_back, sum);
+    report("modulo", wl, ops, now_sec() - t0, sum, sum);
+    mod_destroy(dq);
+    return sum;
+}
+
+static void run_deque(const char* name, CircularDeque* dq, Workload wl, uint64_t ops,
+                      uint64_t expect) {
+    uint64_t sum = 0;
+    double t0 = now_sec();
+    RUN_WORKLOAD(wl, ops, dq, deque_push_front, deque_push_back, deque_pop_front, deque_pop_back, sum);
+    report(name, wl, ops, now_sec() - t0, sum, expect);
+    deque_destroy(dq);
+}
+
+/* The queue workload in batches: BURST pushes as one run, BURST pops as one. */
+static void run_bulk(uint64_t ops, uint64_t expect) {
+    CircularDeque* dq = deque_create_growable(16);
+    int in[BURST], out[BURST];
+    for (int k = 0; k < BURST; ++k) in[k] = k;
+    for (int i = 0; i < WORKING; ++i) deque_push_back(dq, i);
+    uint64_t sum = 0;
+    double t0 = now_sec();
+    for (uint64_t n = 0; n < ops; n += 2 * BURST) {
+        deque_push_back_n(dq, in, BURST);
+        int got = deque_pop_front_n(dq, out, BURST);
+        for (int k = 0; k < got; ++k) sum += (uint64_t)out[k];
+    }
+    report("bulk", WL_QUEUE, ops, now_sec() - t0, sum, expect);
+    deque_destroy(dq);
+}
+
+int main(int argc, char** argv) {
+    uint64_t ops = (argc > 1 ? strtoull(argv[1], NULL, 0) : 100u) * 1000000u;
+    printf("%llu ops per run, %d elements held\n", (unsigned long long)ops, WORKING);
+    uint64_t queue_sum = 0;
+    for (int w = WL_QUEUE; w <= WL_MIXED; ++w) {
+        uint64_t sum = run_modulo((Workload)w, ops);
+        if (w == WL_QUEUE) queue_sum = sum;
+        run_deque("fixed", deque_create(1000), (Workload)w, ops, sum);
+        run_deque("fixed-pow2", deque_create(1024), (Workload)w, ops, sum);
+        run_deque("growable", deque_create_growable(16), (Workload)w, ops, sum);
+    }
+    run_bulk(ops, queue_sum);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+// bench_generic.c - inline elements vs indices into a side array.
+//
+// A FIFO of 48-byte task descriptors held at a steady length: each step
+// pops the front task, "runs" it (reads all its fields) and pushes a new one
+// at the back.
+//   side array  int CircularDeque of slot indices; the tasks live in a
+//               separate array with a free list, slots in shuffled order
+//               (as they end up once producers and consumers interleave)
+//   inline      DEQUE_DEFINE'd deque of the Task struct itself
+// Plus the same FIFO of plain ints through deque.c and through
+// DEQUE_DEFINE(int), to show what inlining does for a small POD type.
+//
+// usage: bench_generic [million_steps]
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "deque.h"
+#include "deque_generic.h"
+
+typedef struct {
+    uint64_t id;
+    uint64_t arg[4];
+    uint32_t kind;
+    uint32_t flags;
+} Task;
+
+DEQUE_DEFINE(TaskDeque, task_deque, Task)
+DEQUE_DEFINE(IntDeque, int_deque, int)
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static Task make_task(uint64_t id) {
+    Task t = { id, { id * 3, id * 5, id * 7, id * 11 }, (uint32_t)id & 7, 1 };
+    return t;
+}
+
+static uint64_t run_task(const Task* t) {
+    return t->id + t->arg[0] + t->arg[1] + t->arg[2] + t->arg[3] + t->kind + t->flags;
+}
+
+static uint64_t side_array(int len, uint64_t steps, double* sec) {
+    CircularDeque* dq = deque_create(len);
+    Task* tasks = malloc(sizeof(Task) * (size_t)len);
+    int* slots = malloc(sizeof(int) * (size_t)len);
+    int* free_list = malloc(sizeof(int) * (size_t)len);
+    int n_free = 0;
+
+    for (int i = 0; i < len; ++i) slots[i] = i;
+    srand(1);
+    for (int i = len - 1; i > 0; --i) {
+        int j = rand() % (i + 1);
+        int tmp = slots[i]; slots[i] = slots[j]; slots[j] = tmp;
+    }
+    for (int i = 0; i < len; ++i) {
+        tasks[slots[i]] = make_task((uint64_t)i);
+        deque_push_back(dq, slots[i]);
+    }
+
+    uint64_t sum = 0, next = (uint64_t)len;
+    double t0 = now_sec();
+    for (uint64_t s = 0; s < steps; ++s) {
+        int slot;
+        if (!deque_pop_front(dq, &slot)) break;
+        sum += run_task(&tasks[slot]);
+        free_list[n_free++] = slot;
+
+        slot = free_list[--n_free];
+        tasks[slot] = make_task(next++);
+        deque_push_back(dq, slot);
+    }
+    *sec = now_sec() - t0;
+
+    free(free_list);
+    free(slots);
+    free(tasks);
+    deque_destroy(dq);
+    return sum;
+}
+
+static uint64_t inline_tasks(int len, uint64_t steps, double* sec) {
+    TaskDeque* dq = task_deque_create(len);
+    for (int i = 0; i < len; ++i) task_deque_push_back(dq, make_task((uint64_t)i));
+
+    uint64_t sum = 0, next = (uint64_t)len;
+    double t0 = now_sec();
+    for (uint64_t s = 0; s < steps; ++s) {
+        Task t;
+        if (!task_deque_pop_front(dq, &t)) break;
+        sum += run_task(&t);
+        task_deque_push_back(dq, make_task(next++));
+    }
+    *sec = now_sec() - t0;
+    task_deque_destroy(dq);
+    return sum;
+}
+
+static uint64_t ints_plain(int len, uint64_t steps, double* sec) {
+    CircularDeque* dq = deque_create(len);
+    for (int i = 0; i < len; ++i) deque_push_back(dq, i);
+    uint64_t sum = 0;
+    double t0 = now_sec();
+    for (uint64_t s = 0; s < steps; ++s) {
+        int v;
+        if (!deque_pop_front(dq, &v)) break;
+        sum += (uint64_t)v;
+        deque_push_back(dq, v + 1);
+    }
+    *sec = now_sec() - t0;
+    deque_destroy(dq);
+    return sum;
+}
+
+static uint64_t ints_generic(int len, uint64_t steps, double* sec) {
+    IntDeque* dq = int_deque_create(len);
+    for (int i = 0; i < len; ++i) int_deque_push_back(dq, i);
+    uint64_t sum = 0;
+    double t0 = now_sec();
+    for (uint64_t s = 0; s < steps; ++s) {
+        int v;
+        if (!int_deque_pop_front(dq, &v)) break;
+        sum += (uint64_t)v;
+        int_deque_push_back(dq, v + 1);
+    }
+    *sec = now_sec() - t0;
+    int_deque_destroy(dq);
+    return sum;
+}
+
+int main(int argc, char** argv) {
+    uint64_t steps = (argc > 1 ? strtoull(argv[1], NULL, 0) : 20u) * 1000000u;
+    static const int lens[] = {1024, 65536, 1 << 20};
+
+    printf("%llu steps, %zu-byte tasks\n", (unsigned long long)steps, sizeof(Task));
+    for (size_t l = 0; l < sizeof lens / sizeof lens[0]; ++l) {
+        double t_side, t_inline, t_int, t_gint;
+        uint64_t a = side_array(lens[l], steps, &t_side);
+        uint64_t b = inline_tasks(lens[l], steps, &t_inline);
+        uint64_t c = ints_plain(lens[l], steps, &t_int);
+        uint64_t d = ints_generic(lens[l], steps, &t_gint);
+        printf("len %8d  tasks: side array %6.2f ns/step, inline %6.2f ns/step%s"
+               "  ints: deque.c %5.2f ns/step, generic %5.2f ns/step%s\n",
+               lens[l], t_side * 1e9 / steps, t_inline * 1e9 / steps, a == b ? "" : " MISMATCH",
+               t_int * 1e9 / steps, t_gint * 1e9 / steps, c == d ? "" : " MISMATCH");
+    }
+    return 0;
+}
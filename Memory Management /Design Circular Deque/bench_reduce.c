@@ -0,0 +1,137 @@
+// bench_reduce.c - reductions over a deque's contents, three ways:
+//   rotate  the only way with the end-only API: pop_front then push_back
+//           every element once, so the deque ends as it started
+//   at      deque_at(i) for each i
+//   spans   deque_sum / deque_min_max / deque_count_in_range / deque_find,
+//           block loops over the (up to) two contiguous spans
+// for sum, min+max, count of values in a range, and find (value absent,
+// so the whole deque is scanned). The contents wrap around the end of the
+// storage, so both spans are in play. All three must agree.
+//
+// usage: bench_reduce [elements] [reps]
+#define _POSIX_C_SOURCE 200809L
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "deque.h"
+
+typedef enum { OP_SUM, OP_MIN_MAX, OP_COUNT, OP_FIND } Op;
+
+static const char* const op_name[] = {"sum", "min_max", "count", "find"};
+
+#define RANGE_LO (-1000)
+#define RANGE_HI 1000
+#define ABSENT   INT_MIN   // never stored, so find scans everything
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static inline uint32_t xorshift(uint32_t* s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+/* One body for the element-at-a-time paths: `get` yields element i into v. */
+#define REDUCE_EACH(op, n, get, result)                                         \
+    do {                                                                        \
+        long long sum_ = 0;                                                     \
+        int lo_ = INT_MAX, hi_ = INT_MIN, count_ = 0, found_ = -1;              \
+        for (int i = 0; i < (n); ++i) {                                         \
+            int v;                                                              \
+            get;                                                                \
+            switch (op) {                                                       \
+            case OP_SUM: sum_ += v; break;                                      \
+            case OP_MIN_MAX:                                                    \
+                lo_ = v < lo_ ? v : lo_;                                        \
+                hi_ = v > hi_ ? v : hi_;                                        \
+                break;                                                          \
+            case OP_COUNT: count_ += v >= RANGE_LO && v <= RANGE_HI; break;     \
+            case OP_FIND:                                                       \
+                if (found_ < 0 && v == ABSENT) found_ = i;                      \
+                break;                                                          \
+            }                                                                   \
+        }                                                                       \
+        switch (op) {                                                           \
+        case OP_SUM: result = sum_; break;                                      \
+        case OP_MIN_MAX: result = (long long)lo_ * 31 + hi_; break;             \
+        case OP_COUNT: result = count_; break;                                  \
+        case OP_FIND: result = found_; break;                                   \
+        }                                                                       \
+    } while (0)
+
+static long long reduce_rotate(CircularDeque* dq, Op op) {
+    long long result = 0;
+    int n = deque_size(dq);
+    REDUCE_EACH(op, n, (deque_pop_front(dq, &v), deque_push_back(dq, v)), result);
+    return result;
+}
+
+static long long reduce_at(CircularDeque* dq, Op op) {
+    long long result = 0;
+    int n = deque_size(dq);
+    REDUCE_EACH(op, n, deque_at(dq, i, &v), result);
+    return result;
+}
+
+static long long reduce_spans(CircularDeque* dq, Op op) {
+    int lo = 0, hi = 0;
+    switch (op) {
+    case OP_SUM: return deque_sum(dq);
+    case OP_MIN_MAX:
+        deque_min_max(dq, &lo, &hi);
+        return (long long)lo * 31 + hi;
+    case OP_COUNT: return deque_count_in_range(dq, RANGE_LO, RANGE_HI);
+    case OP_FIND: return deque_find(dq, ABSENT);
+    }
+    return 0;
+}
+
+static double run(const char* name, long long (*reduce)(CircularDeque*, Op), CircularDeque* dq,
+                  Op op, int reps, long long* result) {
+    double t0 = now_sec();
+    for (int r = 0; r < reps; ++r) *result = reduce(dq, op);
+    double ns = (now_sec() - t0) * 1e9 / ((double)reps * deque_size(dq));
+    printf("  %-6s %6.3f ns/element  (%lld)\n", name, ns, *result);
+    return ns;
+}
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 20;
+    if (n <= 0 || reps <= 0) return 1;
+
+    // fill, then shift a third of the contents round so they wrap
+    CircularDeque* dq = deque_create(n);
+    uint32_t rng = 12345;
+    for (int i = 0; i < n; ++i) deque_push_back(dq, (int)(xorshift(&rng) % 200001) - 100000);
+    for (int i = 0; i < n / 3; ++i) {
+        int v;
+        deque_pop_front(dq, &v);
+        deque_push_back(dq, v);
+    }
+    DequeSpan spans[2];
+    int count = deque_spans(dq, spans);
+    printf("%d elements in %d span(s) (%d + %d), %d reps\n", n, count, spans[0].len, spans[1].len,
+           reps);
+
+    int bad = 0;
+    for (int o = OP_SUM; o <= OP_FIND; ++o) {
+        long long r_rot, r_at, r_spans;
+        printf("%s\n", op_name[o]);
+        double rot = run("rotate", reduce_rotate, dq, (Op)o, reps, &r_rot);
+        run("at", reduce_at, dq, (Op)o, reps, &r_at);
+        double sp = run("spans", reduce_spans, dq, (Op)o, reps, &r_spans);
+        printf("  spans vs rotate: x%.1f%s\n", rot / sp,
+               r_rot != r_at || r_rot != r_spans ? "  MISMATCH" : "");
+        bad |= r_rot != r_at || r_rot != r_spans;
+    }
+    deque_destroy(dq);
+    return bad;
+}
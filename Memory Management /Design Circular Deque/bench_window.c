@@ -0,0 +1,82 @@
+// bench_window.c - sliding-window min/max/mean per sample: window.c
+// (monotonic deques + running sum, O(1) amortized) against rescanning the
+// last N samples for every output (O(N)). Count windows from 8 to 65536
+// samples over a noisy sine, as an ADC stream would look; both paths must
+// produce the same min/max and (to rounding) mean; exits 1 if they do not.
+//
+// usage: bench_window [million_samples]
+#define _POSIX_C_SOURCE 200809L
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "window.h"
+
+#define NAIVE_BUDGET 4e9   // element visits the rescan may spend per window size
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void naive(const double* x, int n, int window, double* mn, double* mx, double* mean) {
+    for (int i = 0; i < n; ++i) {
+        int from = i + 1 > window ? i + 1 - window : 0;
+        double lo = x[from], hi = x[from], sum = 0;
+        for (int j = from; j <= i; ++j) {
+            lo = x[j] < lo ? x[j] : lo;
+            hi = x[j] > hi ? x[j] : hi;
+            sum += x[j];
+        }
+        mn[i] = lo;
+        mx[i] = hi;
+        mean[i] = sum / (i + 1 - from);
+    }
+}
+
+int main(int argc, char** argv) {
+    int n = (int)((argc > 1 ? strtod(argv[1], NULL) : 4.0) * 1e6);
+    double* x = malloc(sizeof(double) * (size_t)n);
+    double* mn = malloc(sizeof(double) * (size_t)n);
+    double* mx = malloc(sizeof(double) * (size_t)n);
+    double* mean = malloc(sizeof(double) * (size_t)n);
+    double* ref_mn = malloc(sizeof(double) * (size_t)n);
+    double* ref_mx = malloc(sizeof(double) * (size_t)n);
+    double* ref_mean = malloc(sizeof(double) * (size_t)n);
+    srand(7);
+    for (int i = 0; i < n; ++i) {
+        x[i] = 1000.0 * sin(i * 0.001) + (rand() % 2001 - 1000) * 0.05;
+    }
+
+    static const int windows[] = {8, 32, 128, 512, 2048, 8192, 65536};
+    printf("%d samples\n", n);
+    int mismatches = 0;
+    for (size_t k = 0; k < sizeof windows / sizeof windows[0]; ++k) {
+        int window = windows[k];
+        SlidingWindow* w = win_create_count(window);
+        double t0 = now_sec();
+        win_process(w, NULL, x, n, mn, mx, mean);
+        double dt = now_sec() - t0;
+        win_destroy(w);
+
+        int m = NAIVE_BUDGET / window < n ? (int)(NAIVE_BUDGET / window) : n;
+        t0 = now_sec();
+        naive(x, m, window, ref_mn, ref_mx, ref_mean);
+        double dt_naive = now_sec() - t0;
+
+        int bad = 0;
+        for (int i = 0; i < m; ++i) {
+            bad += mn[i] != ref_mn[i] || mx[i] != ref_mx[i] ||
+                   fabs(mean[i] - ref_mean[i]) > 1e-9 * (1.0 + fabs(ref_mean[i]));
+        }
+        printf("window %6d: deques %6.2f ns/sample, rescan %9.2f ns/sample (%d samples)  x%.1f%s\n",
+               window, dt * 1e9 / n, dt_naive * 1e9 / m, m, (dt_naive / m) / (dt / n),
+               bad ? "  MISMATCH" : "");
+        mismatches += bad != 0;
+    }
+    free(x); free(mn); free(mx); free(mean);
+    free(ref_mn); free(ref_mx); free(ref_mean);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+// bench_ws.c - scaling of the work-stealing pool at 1..N threads.
+//   fib       recursive fork/join: fib(n) spawns fib(n-1) and computes
+//             fib(n-2) itself, down to a small sequential cutoff, so there
+//             are millions of tiny tasks
+//   parallel  flat ws_parallel_for over an array, a few hundred ns of
+//             arithmetic per grain-sized piece
+// Each line: time, speedup over the 1-thread pool, and the sequential time.
+// A result that differs from the sequential one prints WRONG and the exit
+// status is 1.
+//
+// usage: bench_ws [max_threads] [fib_n]
+#define _POSIX_C_SOURCE 200809L
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "ws_pool.h"
+
+#define FIB_CUTOFF 12
+#define PF_N       (1u << 24)
+#define PF_GRAIN   1024
+
+static WsPool* pool;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t fib_seq(int n) {
+    return n < 2 ? (uint64_t)n : fib_seq(n - 1) + fib_seq(n - 2);
+}
+
+typedef struct {
+    int n;
+    uint64_t result;
+} FibArg;
+
+static void fib_task(void* arg) {
+    FibArg* f = arg;
+    if (f->n < FIB_CUTOFF) {
+        f->result = fib_seq(f->n);
+        return;
+    }
+    FibArg a = { f->n - 1, 0 }, b = { f->n - 2, 0 };
+    WsGroup g = WS_GROUP_INIT;
+    WsTask t = { fib_task, &a, NULL };
+    ws_spawn(pool, &g, &t);
+    fib_task(&b);
+    ws_wait(pool, &g);
+    f->result = a.result + b.result;
+}
+
+static float* pf_data;
+
+static void pf_body(size_t begin, size_t end, void* ctx) {
+    (void)ctx;
+    for (size_t i = begin; i < end; ++i) {
+        float x = pf_data[i];
+        pf_data[i] = x * x * 0.5f + sqrtf(x + 1.0f) - 0.25f * x;
+    }
+}
+
+static double pf_checksum(void) {
+    double s = 0;
+    for (size_t i = 0; i < PF_N; ++i) s += pf_data[i];
+    return s;
+}
+
+static void pf_reset(void) {
+    for (size_t i = 0; i < PF_N; ++i) pf_data[i] = (float)(i & 1023) / 1024.0f;
+}
+
+int main(int argc, char** argv) {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = argc > 1 ? atoi(argv[1]) : (int)(ncpu > 0 ? ncpu : 1);
+    int fib_n = argc > 2 ? atoi(argv[2]) : 32;
+    if (max_threads < 1) max_threads = 1;
+    pf_data = malloc(sizeof(float) * PF_N);
+
+    double t0 = now_sec();
+    uint64_t expect = fib_seq(fib_n);
+    double fib_seq_t = now_sec() - t0;
+
+    pf_reset();
+    t0 = now_sec();
+    pf_body(0, PF_N, NULL);
+    double pf_seq_t = now_sec() - t0;
+    double pf_expect = pf_checksum();
+
+    printf("fib(%d) cutoff %d, parallel_for %u floats grain %d, %ld cpus online\n",
+           fib_n, FIB_CUTOFF, PF_N, PF_GRAIN, ncpu);
+    double fib_one = 0, pf_one = 0;
+    int wrong = 0;
+    for (int n = 1; n <= max_threads; n = n < 4 ? n + 1 : (n * 2 > max_threads && n != max_threads ? max_threads : n * 2)) {
+        pool = ws_pool_create(n);
+        if (!pool) {
+            fprintf(stderr, "ws_pool_create(%d) failed\n", n);
+            return 1;
+        }
+        FibArg f = { fib_n, 0 };
+        t0 = now_sec();
+        fib_task(&f);
+        double fib_t = now_sec() - t0;
+
+        pf_reset();
+        t0 = now_sec();
+        ws_parallel_for(pool, PF_N, PF_GRAIN, pf_body, NULL);
+        double pf_t = now_sec() - t0;
+        ws_pool_destroy(pool);
+
+        bool fib_ok = f.result == expect, pf_ok = pf_checksum() == pf_expect;
+        wrong += !fib_ok + !pf_ok;
+        if (n == 1) {
+            fib_one = fib_t;
+            pf_one = pf_t;
+        }
+        printf("threads %3d  fib %8.1f ms x%5.2f (seq %.1f ms)%s"
+               "  parallel_for %7.1f ms x%5.2f (seq %.1f ms)%s\n",
+               n, fib_t * 1e3, fib_one / fib_t, fib_seq_t * 1e3, fib_ok ? "" : " WRONG",
+               pf_t * 1e3, pf_one / pf_t, pf_seq_t * 1e3, pf_ok ? "" : " WRONG");
+    }
+    free(pf_data);
+    return wrong ? 1 : 0;
+}
@@ -13,6 +13,15 @@ typedef struct CircularDeque CircularDeque;
  */
 CircularDeque* deque_create(int capacity);
 
+/**
+ * Create a growable deque: a push onto a full deque doubles the storage
+ * instead of failing (amortized O(1)).
+ *
+ * @param initial_capacity  Rounded up to a power of two, so index math is a
+ *                          mask. Must be > 0. Returns NULL on error.
+ */
+CircularDeque* deque_create_growable(int initial_capacity);
+
 /**
  * Destroy the deque and free all associated memory.
  * Safe to call with NULL.
@@ -25,7 +34,8 @@ void deque_destroy(CircularDeque* dq);
 int deque_size(const CircularDeque* dq);
 
 /**
- * Get the maximum capacity of the deque (set at creation time).
+ * Get the maximum capacity of the deque (set at creation time; for a
+ * growable deque, the current allocation).
  */
 int deque_capacity(const CircularDeque* dq);
 
@@ -35,7 +45,7 @@ int deque_capacity(const CircularDeque* dq);
 bool deque_is_empty(const CircularDeque* dq);
 
 /**
- * Returns true if the deque is full.
+ * Returns true if the deque is full. Never true for a growable deque.
  */
 bool deque_is_full(const CircularDeque* dq);
 
@@ -69,6 +79,22 @@ bool deque_pop_front(CircularDeque* dq, int* out_value);
  */
 bool deque_pop_back(CircularDeque* dq, int* out_value);
 
+/**
+ * Insert n elements at the back, in order, copied as contiguous runs.
+ *
+ * @return Number inserted: all n, or as many as fit in a fixed-capacity
+ *         deque. A growable deque inserts all or (allocation failure) none.
+ */
+int deque_push_back_n(CircularDeque* dq, const int* values, int n);
+
+/**
+ * Remove up to n elements from the front, copied as contiguous runs.
+ *
+ * @param out_values  If non-NULL, receives the removed values, front first.
+ * @return Number removed (less than n if the deque held fewer).
+ */
+int deque_pop_front_n(CircularDeque* dq, int* out_values, int n);
+
 /**
  * Read (without removing) the front element.
  *
@@ -85,4 +111,57 @@ bool deque_front(const CircularDeque* dq, int* out_value);
  */
 bool deque_back(const CircularDeque* dq, int* out_value);
 
+/**
+ * Read (without removing) the i-th element from the front, in O(1).
+ *
+ * @param out_value  Must be non-NULL to receive the value.
+ * @return true on success, false if i is out of range or dq/out_value is NULL.
+ */
+bool deque_at(const CircularDeque* dq, int i, int* out_value);
+
+/**
+ * A contiguous run of elements in the deque's storage.
+ */
+typedef struct {
+    const int* data;
+    int len;
+} DequeSpan;
+
+/**
+ * The contents, front to back, as at most two contiguous runs: from the
+ * front to the end of the storage, then from the start of the storage.
+ * The pointers stay valid until the next push or pop.
+ *
+ * @param spans  Receives the runs; entries past the returned count are
+ *               set to { NULL, 0 }.
+ * @return Number of non-empty runs: 0 (empty or NULL), 1 or 2.
+ */
+int deque_spans(const CircularDeque* dq, DequeSpan spans[2]);
+
+/**
+ * Sum of all elements (0 if empty), without overflow for any int contents.
+ */
+long long deque_sum(const CircularDeque* dq);
+
+/**
+ * Smallest and largest element.
+ *
+ * @param out_min  If non-NULL, receives the minimum.
+ * @param out_max  If non-NULL, receives the maximum.
+ * @return false if the deque is empty or dq is NULL.
+ */
+bool deque_min_max(const CircularDeque* dq, int* out_min, int* out_max);
+
+/**
+ * Number of elements v with lo <= v <= hi (0 if lo > hi).
+ */
+int deque_count_in_range(const CircularDeque* dq, int lo, int hi);
+
+/**
+ * Position, counted from the front, of the first element equal to value.
+ *
+ * @return The index (as for deque_at), or -1 if not found.
+ */
+int deque_find(const CircularDeque* dq, int value);
+
 #endif /* CIRCULAR_DEQUE_H */
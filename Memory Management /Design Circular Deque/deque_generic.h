@@ -0,0 +1,134 @@
+#ifndef CIRCULAR_DEQUE_GENERIC_H
+#define CIRCULAR_DEQUE_GENERIC_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * Type-generic circular deque: elements are stored inline, by value.
+ *
+ * DEQUE_DEFINE(Name, prefix, T) declares the type Name and the functions
+ * prefix_create, prefix_destroy, prefix_size, prefix_capacity,
+ * prefix_is_empty, prefix_is_full, prefix_push_front, prefix_push_back,
+ * prefix_pop_front, prefix_pop_back, prefix_front and prefix_back, with
+ * the same contract as the int CircularDeque in deque.h (fixed capacity,
+ * O(1), push fails when full, pop/peek fail when empty), plus prefix_at:
+ * a read-only pointer to the i-th element from the front, in place (NULL
+ * if out of range), valid until the next push or pop.
+ *
+ * Everything is static inline, so each use site gets code specialized for
+ * T: element copies are plain assignments the compiler can inline and
+ * vectorize. T must be copyable by assignment (any struct or scalar).
+ *
+ * Example:
+ *     typedef struct { void (*fn)(void*); void* arg; uint64_t id; } Task;
+ *     DEQUE_DEFINE(TaskDeque, task_deque, Task)
+ *
+ *     TaskDeque* q = task_deque_create(1024);
+ *     task_deque_push_back(q, (Task){ run, ctx, 1 });
+ *     Task t;
+ *     while (task_deque_pop_front(q, &t)) t.fn(t.arg);
+ *
+ * Layout: head is the index of the front element, size the element count;
+ * the back element is head + size - 1 (wrapped). Indices wrap with a
+ * compare instead of a division.
+ */
+#define DEQUE_DEFINE(Name, prefix, T)                                           \
+    typedef struct Name {                                                       \
+        T*  data;                                                               \
+        int head;      /* index of front element */                            \
+        int size;      /* current number of elements */                        \
+        int capacity;  /* maximum number of elements */                        \
+    } Name;                                                                     \
+                                                                                \
+    static inline Name* prefix##_create(int capacity) {                         \
+        if (capacity <= 0) return NULL;                                         \
+        Name* dq = (Name*)malloc(sizeof(Name));                                 \
+        if (!dq) return NULL;                                                   \
+        dq->data = (T*)malloc(sizeof(T) * (size_t)capacity);                    \
+        if (!dq->data) {                                                        \
+            free(dq);                                                           \
+            return NULL;                                                        \
+        }                                                                       \
+        dq->head = 0;                                                           \
+        dq->size = 0;                                                           \
+        dq->capacity = capacity;                                                \
+        return dq;                                                              \
+    }                                                                           \
+                                                                                \
+    static inline void prefix##_destroy(Name* dq) {                             \
+        if (!dq) return;                                                        \
+        free(dq->data);                                                         \
+        free(dq);                                                               \
+    }                                                                           \
+                                                                                \
+    static inline int prefix##_size(const Name* dq) {                           \
+        return dq ? dq->size : 0;                                               \
+    }                                                                           \
+                                                                                \
+    static inline int prefix##_capacity(const Name* dq) {                       \
+        return dq ? dq->capacity : 0;                                           \
+    }                                                                           \
+                                                                                \
+    static inline bool prefix##_is_empty(const Name* dq) {                      \
+        return !dq || dq->size == 0;                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool prefix##_is_full(const Name* dq) {                       \
+        return dq && dq->size == dq->capacity;                                  \
+    }                                                                           \
+                                                                                \
+    /* index of the i-th element from the front, 0 <= i < capacity */         \
+    static inline int prefix##_index_(const Name* dq, int i) {                  \
+        int idx = dq->head + i;                                                 \
+        return idx >= dq->capacity ? idx - dq->capacity : idx;                  \
+    }                                                                           \
+                                                                                \
+    static inline const T* prefix##_at(const Name* dq, int i) {                 \
+        if (!dq || i < 0 || i >= dq->size) return NULL;                         \
+        return &dq->data[prefix##_index_(dq, i)];                               \
+    }                                                                           \
+                                                                                \
+    static inline bool prefix##_push_front(Name* dq, T value) {                 \
+        if (!dq || dq->size == dq->capacity) return false;                      \
+        dq->head = dq->head == 0 ? dq->capacity - 1 : dq->head - 1;             \
+        dq->data[dq->head] = value;                                             \
+        dq->size++;                                                             \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool prefix##_push_back(Name* dq, T value) {                  \
+        if (!dq || dq->size == dq->capacity) return false;                      \
+        dq->data[prefix##_index_(dq, dq->size)] = value;                        \
+        dq->size++;                                                             \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool prefix##_pop_front(Name* dq, T* out_value) {             \
+        if (!dq || dq->size == 0) return false;                                 \
+        if (out_value) *out_value = dq->data[dq->head];                         \
+        dq->head = prefix##_index_(dq, 1);                                      \
+        dq->size--;                                                             \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool prefix##_pop_back(Name* dq, T* out_value) {              \
+        if (!dq || dq->size == 0) return false;                                 \
+        dq->size--;                                                             \
+        if (out_value) *out_value = dq->data[prefix##_index_(dq, dq->size)];    \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool prefix##_front(const Name* dq, T* out_value) {           \
+        if (!dq || !out_value || dq->size == 0) return false;                   \
+        *out_value = dq->data[dq->head];                                        \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool prefix##_back(const Name* dq, T* out_value) {            \
+        if (!dq || !out_value || dq->size == 0) return false;                   \
+        *out_value = dq->data[prefix##_index_(dq, dq->size - 1)];               \
+        return true;                                                            \
+    }
+
+#endif /* CIRCULAR_DEQUE_GENERIC_H */
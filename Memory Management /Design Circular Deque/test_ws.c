@@ -0,0 +1,187 @@
+// test_ws.c - stress tests for the work-stealing deque and the pool, using
+// assert. Meant to be run under -fsanitize=thread as well. Build: see README.
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "ws_deque.h"
+#include "ws_pool.h"
+
+#define ASSERT_TRUE(x)  assert((x))
+#define ASSERT_EQ(a,b)  assert((a) == (b))
+
+#define WS_ITEMS   200000
+#define WS_THIEVES 3
+#define WS_INITIAL 256          // the pool's starting deque size
+
+static int items[WS_ITEMS];
+static atomic_int taken[WS_ITEMS];
+static atomic_bool owner_done;
+static WsDeque* shared;
+
+static void take(void* item) {
+    int i = (int)((int*)item - items);
+    ASSERT_TRUE(i >= 0 && i < WS_ITEMS);
+    atomic_fetch_add_explicit(&taken[i], 1, memory_order_relaxed);
+}
+
+static void test_deque_single_thread(void) {
+    ASSERT_TRUE(!ws_deque_create(0));
+    WsDeque* dq = ws_deque_create(3);
+    ASSERT_TRUE(dq);
+    ASSERT_TRUE(!ws_deque_push(dq, NULL));
+    ASSERT_TRUE(!ws_deque_pop(dq) && !ws_deque_steal(dq));
+
+    // owner end is LIFO, thief end FIFO, across two doublings
+    for (int i = 0; i < 10; ++i) ASSERT_TRUE(ws_deque_push(dq, &items[i]));
+    ASSERT_EQ(ws_deque_size(dq), 10);
+    ASSERT_TRUE(ws_deque_steal(dq) == &items[0]);
+    ASSERT_TRUE(ws_deque_pop(dq) == &items[9]);
+    ASSERT_TRUE(ws_deque_steal(dq) == &items[1]);
+    for (int i = 8; i >= 2; --i) ASSERT_TRUE(ws_deque_pop(dq) == &items[i]);
+    ASSERT_TRUE(!ws_deque_pop(dq) && !ws_deque_steal(dq));
+    ASSERT_EQ(ws_deque_size(dq), 0);
+    ws_deque_destroy(dq);
+}
+
+static void* thief_main(void* arg) {
+    (void)arg;
+    for (;;) {
+        // read the flag first: once it is set, an empty steal means done
+        bool done = atomic_load(&owner_done);
+        void* item = ws_deque_steal(shared);
+        if (item) {
+            take(item);
+        } else if (done && ws_deque_size(shared) == 0) {
+            return NULL;
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+/* One owner pushing in bursts well past WS_INITIAL and popping, thieves
+ * stealing all along: every item is taken exactly once. */
+static void test_deque_owner_and_thieves(void) {
+    shared = ws_deque_create(WS_INITIAL);
+    atomic_store(&owner_done, false);
+    for (int i = 0; i < WS_ITEMS; ++i) atomic_init(&taken[i], 0);
+
+    pthread_t thieves[WS_THIEVES];
+    for (int t = 0; t < WS_THIEVES; ++t) {
+        ASSERT_EQ(pthread_create(&thieves[t], NULL, thief_main, NULL), 0);
+    }
+    uint32_t rng = 1;
+    int next = 0, peak = 0;
+    while (next < WS_ITEMS) {
+        rng = rng * 1103515245u + 12345u;
+        int burst = (int)(rng >> 16) % 4096 + 1;
+        for (int k = 0; k < burst && next < WS_ITEMS; ++k) {
+            ASSERT_TRUE(ws_deque_push(shared, &items[next++]));
+        }
+        if (ws_deque_size(shared) > peak) peak = ws_deque_size(shared);
+        for (int k = (int)(rng >> 8) % (burst + 1); k > 0; --k) {
+            void* item = ws_deque_pop(shared);
+            if (!item) break;
+            take(item);
+        }
+    }
+    for (void* item; (item = ws_deque_pop(shared)); ) take(item);
+    atomic_store(&owner_done, true);
+    for (int t = 0; t < WS_THIEVES; ++t) pthread_join(thieves[t], NULL);
+
+    ASSERT_TRUE(peak > WS_INITIAL);
+    for (int i = 0; i < WS_ITEMS; ++i) ASSERT_EQ(atomic_load(&taken[i]), 1);
+    ws_deque_destroy(shared);
+}
+
+static WsPool* pool;
+
+static uint64_t fib_seq(int n) {
+    return n < 2 ? (uint64_t)n : fib_seq(n - 1) + fib_seq(n - 2);
+}
+
+typedef struct {
+    int n;
+    uint64_t result;
+} FibArg;
+
+static void fib_task(void* arg) {
+    FibArg* f = arg;
+    if (f->n < 8) {
+        f->result = fib_seq(f->n);
+        return;
+    }
+    FibArg a = { f->n - 1, 0 }, b = { f->n - 2, 0 };
+    WsGroup g = WS_GROUP_INIT;
+    WsTask t = { fib_task, &a, NULL };
+    ws_spawn(pool, &g, &t);
+    fib_task(&b);
+    ws_wait(pool, &g);
+    f->result = a.result + b.result;
+}
+
+#define PF_N     100003
+#define PF_GRAIN 64
+
+static atomic_int hits[PF_N];
+static atomic_int oversized;
+
+static void pf_body(size_t begin, size_t end, void* ctx) {
+    ASSERT_TRUE(ctx == &hits);
+    if (end - begin > PF_GRAIN) atomic_fetch_add(&oversized, 1);
+    for (size_t i = begin; i < end; ++i) atomic_fetch_add_explicit(&hits[i], 1, memory_order_relaxed);
+}
+
+static void* outside_spawn(void* arg) {
+    // not a worker: the task runs on the spot
+    FibArg* f = arg;
+    WsGroup g = WS_GROUP_INIT;
+    WsTask t = { fib_task, f, NULL };
+    ws_spawn(pool, &g, &t);
+    ASSERT_EQ(atomic_load(&g.pending), 0);
+    ws_wait(pool, &g);
+    return NULL;
+}
+
+static void test_pool(void) {
+    ASSERT_TRUE(!ws_pool_create(0));
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        pool = ws_pool_create(threads);
+        ASSERT_TRUE(pool);
+        ASSERT_EQ(ws_pool_threads(pool), threads);
+
+        for (int n = 0; n <= 24; n += 6) {
+            FibArg f = { n, 0 };
+            fib_task(&f);
+            ASSERT_EQ(f.result, fib_seq(n));
+        }
+
+        static const size_t sizes[] = { 0, 1, PF_GRAIN, PF_GRAIN + 1, PF_N };
+        for (size_t s = 0; s < sizeof sizes / sizeof sizes[0]; ++s) {
+            for (size_t i = 0; i < PF_N; ++i) atomic_store(&hits[i], 0);
+            atomic_store(&oversized, 0);
+            ws_parallel_for(pool, sizes[s], PF_GRAIN, pf_body, &hits);
+            for (size_t i = 0; i < PF_N; ++i) ASSERT_EQ(atomic_load(&hits[i]), i < sizes[s]);
+            ASSERT_EQ(atomic_load(&oversized), 0);
+        }
+
+        FibArg f = { 15, 0 };
+        pthread_t other;
+        ASSERT_EQ(pthread_create(&other, NULL, outside_spawn, &f), 0);
+        pthread_join(other, NULL);
+        ASSERT_EQ(f.result, fib_seq(15));
+
+        ws_pool_destroy(pool);
+    }
+}
+
+int main(void) {
+    test_deque_single_thread();
+    test_deque_owner_and_thieves();
+    test_pool();
+    return 0;
+}
@@ -0,0 +1,464 @@
+// tests.c - acceptance tests using assert. Build: see README.
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "deque.h"
+#include "deque_generic.h"
+#include "window.h"
+
+#define ASSERT_TRUE(x)  assert((x))
+#define ASSERT_EQ(a,b)  assert((a) == (b))
+
+typedef struct {
+    int64_t id;
+    double  x;
+    char    tag[12];
+} Rec;
+
+DEQUE_DEFINE(RecDeque, rec_deque, Rec)
+DEQUE_DEFINE(ShortDeque, short_deque, short)
+
+static Rec rec(int64_t id) {
+    Rec r = { id, id * 0.5, {0} };
+    memcpy(r.tag, &id, sizeof id);
+    return r;
+}
+
+static int rec_eq(Rec a, Rec b) {
+    return a.id == b.id && a.x == b.x && memcmp(a.tag, b.tag, sizeof a.tag) == 0;
+}
+
+static void test_generic_contract(void) {
+    ASSERT_TRUE(!rec_deque_create(0));
+    ASSERT_TRUE(rec_deque_is_empty(NULL) && !rec_deque_is_full(NULL));
+    ASSERT_EQ(rec_deque_size(NULL), 0);
+    ASSERT_TRUE(!rec_deque_push_back(NULL, rec(1)) && !rec_deque_at(NULL, 0));
+    rec_deque_destroy(NULL);
+
+    RecDeque* dq = rec_deque_create(3);
+    Rec r;
+    ASSERT_TRUE(dq && rec_deque_capacity(dq) == 3);
+
+    // empty: every pop and peek fails and leaves r alone
+    r = rec(-1);
+    ASSERT_TRUE(!rec_deque_pop_front(dq, &r) && !rec_deque_pop_back(dq, &r));
+    ASSERT_TRUE(!rec_deque_front(dq, &r) && !rec_deque_back(dq, &r));
+    ASSERT_TRUE(rec_eq(r, rec(-1)) && !rec_deque_at(dq, 0));
+
+    // both ends, across the wrap: head walks back from 0 to 2
+    ASSERT_TRUE(rec_deque_push_back(dq, rec(10)));     // [10]
+    ASSERT_TRUE(rec_deque_push_front(dq, rec(5)));     // [5, 10]
+    ASSERT_TRUE(rec_deque_push_back(dq, rec(20)));     // [5, 10, 20]
+    ASSERT_TRUE(rec_deque_is_full(dq) && !rec_deque_is_empty(dq));
+    ASSERT_TRUE(!rec_deque_push_back(dq, rec(99)) && !rec_deque_push_front(dq, rec(99)));
+    ASSERT_EQ(rec_deque_size(dq), 3);
+
+    ASSERT_TRUE(rec_deque_front(dq, &r) && rec_eq(r, rec(5)));
+    ASSERT_TRUE(rec_deque_back(dq, &r) && rec_eq(r, rec(20)));
+    ASSERT_TRUE(rec_eq(*rec_deque_at(dq, 0), rec(5)));
+    ASSERT_TRUE(rec_eq(*rec_deque_at(dq, 1), rec(10)));
+    ASSERT_TRUE(rec_eq(*rec_deque_at(dq, 2), rec(20)));
+    ASSERT_TRUE(!rec_deque_at(dq, 3) && !rec_deque_at(dq, -1));
+
+    ASSERT_TRUE(rec_deque_pop_back(dq, &r) && rec_eq(r, rec(20)));
+    ASSERT_TRUE(rec_deque_pop_front(dq, NULL));        // drops 5
+    ASSERT_TRUE(rec_deque_push_back(dq, rec(30)));     // wraps past the end
+    ASSERT_TRUE(rec_deque_push_back(dq, rec(40)));
+    ASSERT_TRUE(rec_eq(*rec_deque_at(dq, 2), rec(40)));
+    ASSERT_TRUE(rec_deque_pop_front(dq, &r) && rec_eq(r, rec(10)));
+    ASSERT_TRUE(rec_deque_pop_front(dq, &r) && rec_eq(r, rec(30)));
+    ASSERT_TRUE(rec_deque_pop_front(dq, &r) && rec_eq(r, rec(40)));
+    ASSERT_TRUE(rec_deque_is_empty(dq) && !rec_deque_pop_back(dq, &r));
+    rec_deque_destroy(dq);
+}
+
+/* Random ops at both ends against a plain array kept front-first. */
+static void test_generic_differential(void) {
+    enum { CAP = 7, STEPS = 20000 };
+    ShortDeque* dq = short_deque_create(CAP);
+    short ref[CAP];
+    int n = 0;
+    unsigned seed = 1;
+    for (int step = 0; step < STEPS; ++step) {
+        seed = seed * 1103515245u + 12345u;
+        short v = (short)(seed >> 16);
+        short got = 0;
+        switch ((seed >> 8) % 4) {
+        case 0:
+            ASSERT_EQ(short_deque_push_back(dq, v), n < CAP);
+            if (n < CAP) ref[n++] = v;
+            break;
+        case 1:
+            ASSERT_EQ(short_deque_push_front(dq, v), n < CAP);
+            if (n < CAP) {
+                memmove(ref + 1, ref, sizeof(short) * (size_t)n);
+                ref[0] = v;
+                n++;
+            }
+            break;
+        case 2:
+            ASSERT_EQ(short_deque_pop_back(dq, &got), n > 0);
+            if (n > 0) ASSERT_EQ(got, ref[--n]);
+            break;
+        case 3:
+            ASSERT_EQ(short_deque_pop_front(dq, &got), n > 0);
+            if (n > 0) {
+                ASSERT_EQ(got, ref[0]);
+                memmove(ref, ref + 1, sizeof(short) * (size_t)--n);
+            }
+            break;
+        }
+        ASSERT_EQ(short_deque_size(dq), n);
+        ASSERT_EQ(short_deque_is_full(dq), n == CAP);
+        for (int i = 0; i < n; ++i) ASSERT_EQ(*short_deque_at(dq, i), ref[i]);
+        ASSERT_TRUE(!short_deque_at(dq, n));
+    }
+    short_deque_destroy(dq);
+}
+
+/* Put the contents of a deque of the given capacity in wrapped state:
+ * `lead` elements at the end of the storage, the rest from index 0. */
+static CircularDeque* wrapped(int capacity, bool growable, int lead, int count, int first) {
+    CircularDeque* dq = growable ? deque_create_growable(capacity) : deque_create(capacity);
+    int cap = deque_capacity(dq);
+    for (int i = 0; i < cap - lead; ++i) deque_push_back(dq, -1);
+    for (int i = 0; i < cap - lead; ++i) deque_pop_front(dq, NULL);
+    for (int i = 0; i < count; ++i) ASSERT_TRUE(deque_push_back(dq, first + i));
+    return dq;
+}
+
+static void expect_run(CircularDeque* dq, int first, int count) {
+    ASSERT_EQ(deque_size(dq), count);
+    for (int i = 0; i < count; ++i) {
+        int v = 0;
+        ASSERT_TRUE(deque_pop_front(dq, &v));
+        ASSERT_EQ(v, first + i);
+    }
+    ASSERT_TRUE(deque_is_empty(dq));
+}
+
+/* Growth from every wrapped layout keeps the order, whichever push grows. */
+static void test_growable_keeps_order(void) {
+    ASSERT_TRUE(!deque_create_growable(0));
+    CircularDeque* dq = deque_create_growable(5);
+    ASSERT_EQ(deque_capacity(dq), 8);                  // rounded up to a power of two
+    ASSERT_TRUE(!deque_is_full(dq));
+    deque_destroy(dq);
+
+    for (int lead = 0; lead <= 8; ++lead) {
+        // push_back past full
+        dq = wrapped(8, true, lead, 8, 100);
+        ASSERT_TRUE(!deque_is_full(dq));
+        for (int i = 8; i < 20; ++i) ASSERT_TRUE(deque_push_back(dq, 100 + i));
+        ASSERT_EQ(deque_capacity(dq), 32);
+        expect_run(dq, 100, 20);
+        deque_destroy(dq);
+
+        // push_front past full
+        dq = wrapped(8, true, lead, 8, 100);
+        ASSERT_TRUE(deque_push_front(dq, 99));
+        ASSERT_TRUE(deque_push_front(dq, 98));
+        ASSERT_EQ(deque_capacity(dq), 16);
+        expect_run(dq, 98, 10);
+        deque_destroy(dq);
+
+        // one bulk push that needs several doublings
+        dq = wrapped(8, true, lead, 6, 0);
+        int in[50];
+        for (int i = 0; i < 50; ++i) in[i] = 6 + i;
+        ASSERT_EQ(deque_push_back_n(dq, in, 50), 50);
+        ASSERT_EQ(deque_capacity(dq), 64);
+        expect_run(dq, 0, 56);
+        deque_destroy(dq);
+    }
+}
+
+/* Bulk ops at every wrap position, fixed (pow2 and not) and growable,
+ * against a deque fed one element at a time. */
+static void test_bulk_differential(void) {
+    static const struct { int capacity; bool growable; } kinds[] = {
+        {7, false}, {8, false}, {4, true},
+    };
+    int in[64], out[64];
+    unsigned seed = 7;
+    for (size_t k = 0; k < sizeof kinds / sizeof kinds[0]; ++k) {
+        CircularDeque* dq = kinds[k].growable ? deque_create_growable(kinds[k].capacity)
+                                              : deque_create(kinds[k].capacity);
+        CircularDeque* ref = deque_create(1 << 16);
+        int next = 0;
+        for (int step = 0; step < 20000; ++step) {
+            seed = seed * 1103515245u + 12345u;
+            int n = (int)((seed >> 16) % 20u);
+            switch ((seed >> 8) % 4u) {
+            case 0: {
+                for (int i = 0; i < n; ++i) in[i] = next++;
+                int pushed = deque_push_back_n(dq, in, n);
+                int room = deque_capacity(dq) - (deque_size(dq) - pushed);
+                ASSERT_EQ(pushed, kinds[k].growable || n <= room ? n : room);
+                for (int i = 0; i < pushed; ++i) deque_push_back(ref, in[i]);
+                break;
+            }
+            case 1: {
+                int popped = deque_pop_front_n(dq, (seed & 1) ? out : NULL, n);
+                ASSERT_EQ(popped, n < deque_size(ref) ? n : deque_size(ref));
+                for (int i = 0; i < popped; ++i) {
+                    int v = 0;
+                    deque_pop_front(ref, &v);
+                    if (seed & 1) ASSERT_EQ(out[i], v);
+                }
+                break;
+            }
+            case 2:
+                if (deque_push_front(dq, next)) ASSERT_TRUE(deque_push_front(ref, next));
+                next++;
+                break;
+            case 3: {
+                int a = 0, b = 0;
+                ASSERT_EQ(deque_pop_back(dq, &a), deque_pop_back(ref, &b));
+                ASSERT_EQ(a, b);
+                break;
+            }
+            }
+            ASSERT_EQ(deque_size(dq), deque_size(ref));
+        }
+        int a = 0, b = 0;
+        while (deque_pop_front(ref, &b)) {
+            ASSERT_TRUE(deque_pop_front(dq, &a));
+            ASSERT_EQ(a, b);
+        }
+        ASSERT_TRUE(deque_is_empty(dq));
+        ASSERT_EQ(deque_push_back_n(dq, in, 0), 0);
+        ASSERT_EQ(deque_pop_front_n(dq, out, 5), 0);
+        deque_destroy(dq);
+        deque_destroy(ref);
+    }
+}
+
+static void expect_stats(const SlidingWindow* w, double min, double max, double mean, int count) {
+    WinStats st;
+    ASSERT_TRUE(win_stats(w, &st));
+    ASSERT_EQ(st.min, min);
+    ASSERT_EQ(st.max, max);
+    ASSERT_EQ(st.count, count);
+    ASSERT_TRUE(fabs(st.mean - mean) <= 1e-12 * (1.0 + fabs(mean)));
+}
+
+static void test_window_count(void) {
+    ASSERT_TRUE(!win_create_count(0));
+    ASSERT_TRUE(!win_push(NULL, 0, 1.0));
+    win_destroy(NULL);
+
+    SlidingWindow* w = win_create_count(3);
+    WinStats st;
+    ASSERT_TRUE(!win_stats(w, &st) && !win_stats(w, NULL));
+    ASSERT_TRUE(win_push(w, 0, 4));
+    expect_stats(w, 4, 4, 4, 1);
+    ASSERT_TRUE(win_push(w, 0, 1));
+    ASSERT_TRUE(win_push(w, 0, 7));
+    expect_stats(w, 1, 7, 4, 3);
+    ASSERT_TRUE(win_push(w, 0, 2));                     // 4 leaves
+    expect_stats(w, 1, 7, 10.0 / 3, 3);
+    ASSERT_TRUE(win_push(w, 0, 3));                     // 1 leaves: min moves on
+    expect_stats(w, 2, 7, 4, 3);
+    ASSERT_TRUE(win_push(w, 0, 0));                     // 7 leaves: max moves on
+    expect_stats(w, 0, 3, 5.0 / 3, 3);
+    win_destroy(w);
+
+    // 1 is lost when added to 1e16, so after 1e16 leaves the running sum
+    // is off by one; the recompute after `capacity` evictions fixes it
+    w = win_create_count(4);
+    win_push(w, 0, 1e16);
+    for (int i = 0; i < 4; ++i) win_push(w, 0, 1);
+    for (int i = 0; i < 4; ++i) win_push(w, 0, 1);
+    expect_stats(w, 1, 1, 1, 4);
+    win_destroy(w);
+}
+
+static void test_window_time(void) {
+    ASSERT_TRUE(!win_create_time(0, 10) && !win_create_time(10, 0));
+
+    SlidingWindow* w = win_create_time(10, 100);        // t in (now - 10, now]
+    ASSERT_TRUE(win_push(w, 0, 5));
+    ASSERT_TRUE(win_push(w, 5, 1));
+    ASSERT_TRUE(win_push(w, 9, 3));
+    expect_stats(w, 1, 5, 3, 3);
+    ASSERT_TRUE(win_push(w, 10, 4));                    // t = 0 is now out
+    expect_stats(w, 1, 4, 8.0 / 3, 3);
+    ASSERT_TRUE(!win_push(w, 9, 100));                  // backwards: ignored
+    expect_stats(w, 1, 4, 8.0 / 3, 3);
+    ASSERT_TRUE(win_push(w, 10, 2));                    // same time is fine
+    ASSERT_TRUE(win_push(w, 15, 6));                    // t = 5 is out
+    expect_stats(w, 2, 6, 15.0 / 4, 4);
+    ASSERT_TRUE(win_push(w, 1000, -1));                 // a jump empties the rest
+    expect_stats(w, -1, -1, -1, 1);
+    win_destroy(w);
+
+    // max_samples caps a busy window like a count window
+    w = win_create_time(1000, 3);
+    for (int t = 0; t < 5; ++t) ASSERT_TRUE(win_push(w, t, 10 - t));
+    expect_stats(w, 6, 8, 7, 3);
+    win_destroy(w);
+
+    // win_process stops at a backwards timestamp
+    w = win_create_time(4, 8);
+    int64_t ts[] = { 1, 2, 4, 7, 6, 9 };
+    double vs[] = { 3, 1, 2, 5, 0, 0 };
+    double mn[6], mx[6], mean[6];
+    ASSERT_EQ(win_process(w, ts, vs, 6, mn, mx, mean), 4);
+    ASSERT_TRUE(mn[0] == 3 && mn[1] == 1 && mn[2] == 1 && mn[3] == 2);
+    ASSERT_TRUE(mx[3] == 5 && mean[3] == 3.5);
+    ASSERT_EQ(win_process(w, ts + 5, vs + 5, 1, NULL, NULL, NULL), 1);
+    expect_stats(w, 0, 5, 2.5, 2);
+    win_destroy(w);
+}
+
+/* Both window kinds against rescanning what should be in the window. */
+static void test_window_differential(void) {
+    enum { N = 3000 };
+    static int64_t t[N];
+    static double v[N];
+    unsigned seed = 3;
+    int64_t now = 0;
+    for (int i = 0; i < N; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        now += (seed >> 16) % 4u == 0 ? (int64_t)((seed >> 8) % 40u) : 0;
+        t[i] = now;
+        v[i] = (double)((int)(seed >> 12) % 1000 - 500) / 8;
+    }
+    static const int sizes[] = { 1, 2, 3, 8, 61 };
+    for (size_t k = 0; k < sizeof sizes / sizeof sizes[0]; ++k) {
+        int n = sizes[k];
+        SlidingWindow* cw = win_create_count(n);
+        SlidingWindow* tw = win_create_time(n, 16);     // span n, at most 16 kept
+        for (int i = 0; i < N; ++i) {
+            ASSERT_TRUE(win_push(cw, t[i], v[i]));
+            ASSERT_TRUE(win_push(tw, t[i], v[i]));
+            for (int kind = 0; kind < 2; ++kind) {
+                int from = i;
+                while (from > 0 && (kind == 0 ? i - from + 1 < n
+                                              : i - from + 1 < 16 && t[from - 1] > t[i] - n)) {
+                    from--;
+                }
+                double lo = v[from], hi = v[from], sum = 0;
+                for (int j = from; j <= i; ++j) {
+                    lo = fmin(lo, v[j]);
+                    hi = fmax(hi, v[j]);
+                    sum += v[j];
+                }
+                expect_stats(kind == 0 ? cw : tw, lo, hi, sum / (i - from + 1), i - from + 1);
+            }
+        }
+        win_destroy(cw);
+        win_destroy(tw);
+    }
+}
+
+/* Reads and reductions against the reference contents ref[0..n). */
+static void expect_reads(const CircularDeque* dq, const int* ref, int n, int lead) {
+    int v = 0;
+    for (int i = 0; i < n; ++i) {
+        ASSERT_TRUE(deque_at(dq, i, &v));
+        ASSERT_EQ(v, ref[i]);
+    }
+    ASSERT_TRUE(!deque_at(dq, n, &v) && !deque_at(dq, -1, &v) && !deque_at(dq, 0, NULL));
+
+    DequeSpan spans[2];
+    int count = deque_spans(dq, spans);
+    ASSERT_EQ(count, n == 0 ? 0 : n <= lead ? 1 : 2);
+    ASSERT_EQ(spans[0].len + spans[1].len, n);
+    for (int k = count; k < 2; ++k) ASSERT_TRUE(!spans[k].data && spans[k].len == 0);
+    for (int i = 0; i < n; ++i) {
+        ASSERT_EQ(i < spans[0].len ? spans[0].data[i] : spans[1].data[i - spans[0].len], ref[i]);
+    }
+
+    long long sum = 0;
+    int lo = INT_MAX, hi = INT_MIN, mid = 0;
+    for (int i = 0; i < n; ++i) {
+        sum += ref[i];
+        lo = ref[i] < lo ? ref[i] : lo;
+        hi = ref[i] > hi ? ref[i] : hi;
+        mid += ref[i] >= -1 && ref[i] <= 1;
+    }
+    ASSERT_EQ(deque_sum(dq), sum);
+    int got_lo = 7, got_hi = 7;
+    ASSERT_EQ(deque_min_max(dq, &got_lo, &got_hi), n > 0);
+    if (n > 0) ASSERT_TRUE(got_lo == lo && got_hi == hi);
+    else ASSERT_TRUE(got_lo == 7 && got_hi == 7);
+    ASSERT_EQ(deque_min_max(dq, NULL, NULL), n > 0);
+    ASSERT_EQ(deque_count_in_range(dq, INT_MIN, INT_MAX), n);
+    ASSERT_EQ(deque_count_in_range(dq, -1, 1), mid);
+    ASSERT_EQ(deque_count_in_range(dq, 1, -1), 0);
+    for (int i = 0; i < n; ++i) {
+        int first = 0;
+        while (ref[first] != ref[i]) first++;
+        ASSERT_EQ(deque_find(dq, ref[i]), first);
+    }
+    ASSERT_EQ(deque_find(dq, 12345), -1);
+}
+
+/* deque_at, deque_spans and the reductions at every wrap position, for
+ * lengths that leave every possible lane and block tail. */
+static void test_reads_and_reductions(void) {
+    int v = 0;
+    DequeSpan spans[2] = { { &v, 1 }, { &v, 1 } };
+    ASSERT_TRUE(!deque_at(NULL, 0, &v));
+    ASSERT_EQ(deque_spans(NULL, spans), 0);
+    ASSERT_TRUE(!spans[0].data && !spans[1].data);
+    ASSERT_EQ(deque_sum(NULL), 0);
+    ASSERT_TRUE(!deque_min_max(NULL, &v, &v));
+    ASSERT_EQ(deque_count_in_range(NULL, INT_MIN, INT_MAX), 0);
+    ASSERT_EQ(deque_find(NULL, 0), -1);
+
+    enum { CAP = 44, MAX_N = 41 };
+    int ref[MAX_N];
+    unsigned seed = 5;
+    for (int lead = 1; lead <= CAP; ++lead) {
+        for (int n = 0; n <= MAX_N; ++n) {
+            for (int pattern = 0; pattern < 3; ++pattern) {
+                for (int i = 0; i < n; ++i) {
+                    seed = seed * 1103515245u + 12345u;
+                    switch (pattern) {
+                    case 0:     // small values, many repeats
+                        ref[i] = (int)(seed >> 16) % 7 - 3;
+                        break;
+                    case 1:     // extremes last and in the middle
+                        ref[i] = i == n - 1 ? INT_MIN : i == n / 2 ? INT_MAX : i % 5;
+                        break;
+                    default:    // only extremes: sum must not overflow
+                        ref[i] = (seed >> 16) & 1 ? INT_MAX : INT_MIN;
+                        break;
+                    }
+                }
+                CircularDeque* dq = wrapped(CAP, false, lead, 0, 0);
+                ASSERT_EQ(deque_push_back_n(dq, ref, n), n);
+                expect_reads(dq, ref, n, lead);
+                deque_destroy(dq);
+            }
+        }
+    }
+
+    // a deque of one value, at full capacity
+    CircularDeque* dq = wrapped(8, false, 3, 0, 0);
+    for (int i = 0; i < 8; ++i) deque_push_back(dq, INT_MAX);
+    ASSERT_EQ(deque_sum(dq), 8LL * INT_MAX);
+    ASSERT_EQ(deque_count_in_range(dq, INT_MAX, INT_MAX), 8);
+    ASSERT_EQ(deque_count_in_range(dq, INT_MIN, INT_MAX - 1), 0);
+    ASSERT_EQ(deque_find(dq, INT_MAX), 0);
+    deque_destroy(dq);
+}
+
+int main(void) {
+    test_generic_contract();
+    test_generic_differential();
+    test_growable_keeps_order();
+    test_bulk_differential();
+    test_reads_and_reductions();
+    test_window_count();
+    test_window_time();
+    test_window_differential();
+    return 0;
+}
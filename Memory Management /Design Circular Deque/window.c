@@ -0,0 +1,156 @@
+#include "window.h"
+#include "deque_generic.h"
+#include <stdlib.h>
+
+typedef struct {
+    int64_t seq;   // position in the stream
+    int64_t t;     // timestamp
+    double  v;
+} WinSample;
+
+DEQUE_DEFINE(WinDeque, win_deque, WinSample)
+
+struct SlidingWindow {
+    WinDeque* samples;   // everything in the window, oldest first
+    WinDeque* min_q;     // increasing values: front is the minimum
+    WinDeque* max_q;     // decreasing values: front is the maximum
+    int64_t   span;      // time windows; 0 for count windows
+    int64_t   next_seq;
+    double    sum;
+    int       resum;     // evictions until the sum is recomputed
+};
+
+static SlidingWindow* win_alloc(int n, int64_t span) {
+    if (n <= 0 || span < 0) {
+        return NULL;
+    }
+    SlidingWindow* w = (SlidingWindow*)malloc(sizeof(SlidingWindow));
+    if (!w) {
+        return NULL;
+    }
+    w->samples = win_deque_create(n);
+    w->min_q = win_deque_create(n);
+    w->max_q = win_deque_create(n);
+    if (!w->samples || !w->min_q || !w->max_q) {
+        win_destroy(w);
+        return NULL;
+    }
+    w->span = span;
+    w->next_seq = 0;
+    w->sum = 0;
+    w->resum = n;
+    return w;
+}
+
+SlidingWindow* win_create_count(int n) {
+    return win_alloc(n, 0);
+}
+
+SlidingWindow* win_create_time(int64_t span, int max_samples) {
+    if (span <= 0) {
+        return NULL;
+    }
+    return win_alloc(max_samples, span);
+}
+
+void win_destroy(SlidingWindow* w) {
+    if (!w) return;
+    win_deque_destroy(w->samples);
+    win_deque_destroy(w->min_q);
+    win_deque_destroy(w->max_q);
+    free(w);
+}
+
+/* Subtracting evicted samples lets rounding error build up in the sum;
+ * adding the window up again once per capacity evictions keeps it exact
+ * to a few ulps at O(1) amortized cost. */
+static void win_evict_oldest(SlidingWindow* w) {
+    WinSample old;
+    if (!win_deque_pop_front(w->samples, &old)) return;
+    w->sum -= old.v;
+    if (--w->resum == 0) {
+        double sum = 0;
+        for (int i = 0; i < win_deque_size(w->samples); ++i) {
+            sum += win_deque_at(w->samples, i)->v;
+        }
+        w->sum = sum;
+        w->resum = win_deque_capacity(w->samples);
+    }
+}
+
+/* Drop monotonic-queue entries older than the oldest sample kept. */
+static void win_expire(WinDeque* q, int64_t oldest_seq) {
+    const WinSample* front;
+    while ((front = win_deque_at(q, 0)) && front->seq < oldest_seq) {
+        win_deque_pop_front(q, NULL);
+    }
+}
+
+bool win_push(SlidingWindow* w, int64_t t, double value) {
+    if (!w) return false;
+    WinSample s = { w->next_seq, t, value };
+
+    if (w->span) {
+        WinSample newest;
+        if (win_deque_back(w->samples, &newest) && t < newest.t) {
+            return false;
+        }
+        const WinSample* oldest;
+        while ((oldest = win_deque_at(w->samples, 0)) && oldest->t <= t - w->span) {
+            win_evict_oldest(w);
+        }
+    }
+    if (win_deque_is_full(w->samples)) {
+        win_evict_oldest(w);
+    }
+    w->next_seq++;
+
+    win_deque_push_back(w->samples, s);
+    w->sum += value;
+
+    int64_t oldest = win_deque_at(w->samples, 0)->seq;
+    win_expire(w->min_q, oldest);
+    win_expire(w->max_q, oldest);
+
+    // a new sample makes every older, larger (smaller) one irrelevant
+    WinSample back;
+    while (win_deque_back(w->min_q, &back) && back.v >= value) {
+        win_deque_pop_back(w->min_q, NULL);
+    }
+    win_deque_push_back(w->min_q, s);
+    while (win_deque_back(w->max_q, &back) && back.v <= value) {
+        win_deque_pop_back(w->max_q, NULL);
+    }
+    win_deque_push_back(w->max_q, s);
+    return true;
+}
+
+bool win_stats(const SlidingWindow* w, WinStats* out) {
+    if (!w || !out || win_deque_is_empty(w->samples)) return false;
+    out->min = win_deque_at(w->min_q, 0)->v;
+    out->max = win_deque_at(w->max_q, 0)->v;
+    out->count = win_deque_size(w->samples);
+    out->mean = w->sum / out->count;
+    return true;
+}
+
+int win_process(SlidingWindow* w, const int64_t* t, const double* values, int n,
+                double* out_min, double* out_max, double* out_mean) {
+    if (!w || !values || n <= 0) return 0;
+    int64_t now = 0;
+    WinSample newest;
+    if (win_deque_back(w->samples, &newest)) {
+        now = newest.t;
+    }
+    for (int i = 0; i < n; ++i) {
+        if (!win_push(w, t ? t[i] : now, values[i])) {
+            return i;
+        }
+        WinStats st;
+        win_stats(w, &st);
+        if (out_min) out_min[i] = st.min;
+        if (out_max) out_max[i] = st.max;
+        if (out_mean) out_mean[i] = st.mean;
+    }
+    return n;
+}
@@ -0,0 +1,66 @@
+#ifndef SLIDING_WINDOW_H
+#define SLIDING_WINDOW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Streaming sliding-window min / max / mean over a sample stream.
+ *
+ * Two monotonic deques (increasing for the minimum, decreasing for the
+ * maximum) give the extremes in O(1) amortized per sample; a running sum
+ * gives the mean. The window is either the last N samples or the samples
+ * of the last `span` time units.
+ */
+typedef struct SlidingWindow SlidingWindow;
+
+typedef struct {
+    double min;
+    double max;
+    double mean;
+    int    count;   // samples in the window
+} WinStats;
+
+/**
+ * Window over the last n samples (n > 0). Returns NULL on error.
+ */
+SlidingWindow* win_create_count(int n);
+
+/**
+ * Window over samples with timestamp t > now - span, where now is the
+ * latest timestamp pushed. At most max_samples are kept: past that, the
+ * oldest go first, as in a count window. Returns NULL on error.
+ */
+SlidingWindow* win_create_time(int64_t span, int max_samples);
+
+/**
+ * Destroy the window. Safe to call with NULL.
+ */
+void win_destroy(SlidingWindow* w);
+
+/**
+ * Add a sample and drop whatever left the window.
+ *
+ * @param t  Timestamp, non-decreasing (any value for count windows).
+ * @return false if w is NULL or t went backwards (sample ignored).
+ */
+bool win_push(SlidingWindow* w, int64_t t, double value);
+
+/**
+ * Current min / max / mean.
+ *
+ * @return false if w/out is NULL or the window is empty.
+ */
+bool win_stats(const SlidingWindow* w, WinStats* out);
+
+/**
+ * Batch entry point: push n samples and record the window statistics
+ * after each one. t may be NULL (count windows, or all samples at the
+ * same time); any of out_min, out_max, out_mean may be NULL.
+ *
+ * @return Number of samples processed (stops early at a backwards t).
+ */
+int win_process(SlidingWindow* w, const int64_t* t, const double* values, int n,
+                double* out_min, double* out_max, double* out_mean);
+
+#endif /* SLIDING_WINDOW_H */
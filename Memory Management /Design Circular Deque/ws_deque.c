@@ -0,0 +1,155 @@
+#include "ws_deque.h"
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define WS_CACHE_LINE 64
+
+typedef struct WsArray {
+    struct WsArray* prev;  // retired predecessor, freed with the deque
+    int64_t mask;          // size - 1, size a power of two
+    _Atomic(void*) item[];
+} WsArray;
+
+/* top and bottom are free-running positions: the items are
+ * [top, bottom), at index pos & mask. The owner writes bottom, thieves
+ * (and the owner, for the last item) CAS top; each sits on its own line. */
+struct WsDeque {
+    _Alignas(WS_CACHE_LINE)
+    _Atomic int64_t top;           // next to steal
+    _Alignas(WS_CACHE_LINE)
+    _Atomic int64_t bottom;        // next free slot at the back
+    _Atomic(WsArray*) array;
+};
+
+static WsArray* ws_array_new(int64_t size, WsArray* prev) {
+    WsArray* a = malloc(sizeof(WsArray) + sizeof(_Atomic(void*)) * (size_t)size);
+    if (!a) {
+        return NULL;
+    }
+    a->prev = prev;
+    a->mask = size - 1;
+    return a;
+}
+
+WsDeque* ws_deque_create(int initial_capacity) {
+    if (initial_capacity <= 0) {
+        return NULL;
+    }
+    int64_t size = 1;
+    while (size < initial_capacity) size <<= 1;
+
+    WsDeque* dq = aligned_alloc(WS_CACHE_LINE, sizeof(WsDeque));
+    if (!dq) {
+        return NULL;
+    }
+    WsArray* a = ws_array_new(size, NULL);
+    if (!a) {
+        free(dq);
+        return NULL;
+    }
+    atomic_init(&dq->top, 0);
+    atomic_init(&dq->bottom, 0);
+    atomic_init(&dq->array, a);
+    return dq;
+}
+
+void ws_deque_destroy(WsDeque* dq) {
+    if (!dq) return;
+    WsArray* a = atomic_load_explicit(&dq->array, memory_order_relaxed);
+    while (a) {
+        WsArray* prev = a->prev;
+        free(a);
+        a = prev;
+    }
+    free(dq);
+}
+
+/* Owner, deque full: copy [t, b) into an array twice the size. The old
+ * one is kept (thieves may hold it) and freed with the deque. */
+static WsArray* ws_deque_grow(WsDeque* dq, WsArray* a, int64_t t, int64_t b) {
+    if (a->mask + 1 > INT_MAX / 2) {
+        return NULL;
+    }
+    WsArray* n = ws_array_new(2 * (a->mask + 1), a);
+    if (!n) {
+        return NULL;
+    }
+    for (int64_t i = t; i < b; ++i) {
+        void* x = atomic_load_explicit(&a->item[i & a->mask], memory_order_relaxed);
+        atomic_store_explicit(&n->item[i & n->mask], x, memory_order_relaxed);
+    }
+    atomic_store_explicit(&dq->array, n, memory_order_release);
+    return n;
+}
+
+bool ws_deque_push(WsDeque* dq, void* item) {
+    if (!dq || !item) return false;
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    WsArray* a = atomic_load_explicit(&dq->array, memory_order_relaxed);
+    if (b - t > a->mask) {
+        a = ws_deque_grow(dq, a, t, b);
+        if (!a) return false;
+    }
+    atomic_store_explicit(&a->item[b & a->mask], item, memory_order_relaxed);
+    // release: a thief that sees the new bottom also sees the item and
+    // whatever the owner wrote into it before pushing
+    atomic_store_explicit(&dq->bottom, b + 1, memory_order_release);
+    return true;
+}
+
+void* ws_deque_pop(WsDeque* dq) {
+    if (!dq) return NULL;
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed) - 1;
+    WsArray* a = atomic_load_explicit(&dq->array, memory_order_relaxed);
+    atomic_store_explicit(&dq->bottom, b, memory_order_relaxed);
+    // claim slot b before looking at top: a thief either sees the lower
+    // bottom or we see its higher top
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_relaxed);
+
+    void* x = NULL;
+    if (t <= b) {
+        x = atomic_load_explicit(&a->item[b & a->mask], memory_order_relaxed);
+        if (t == b) {
+            // last item: race the thieves for it
+            if (!atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1,
+                                                         memory_order_seq_cst,
+                                                         memory_order_relaxed)) {
+                x = NULL;
+            }
+            atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+        }
+    } else {
+        // was empty
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+    }
+    return x;
+}
+
+void* ws_deque_steal(WsDeque* dq) {
+    if (!dq) return NULL;
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+    if (t >= b) {
+        return NULL;
+    }
+    WsArray* a = atomic_load_explicit(&dq->array, memory_order_acquire);
+    void* x = atomic_load_explicit(&a->item[t & a->mask], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1,
+                                                 memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+        return NULL;    // lost to another thief or the owner
+    }
+    return x;
+}
+
+int ws_deque_size(const WsDeque* dq) {
+    if (!dq) return 0;
+    int64_t b = atomic_load_explicit(&((WsDeque*)dq)->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&((WsDeque*)dq)->top, memory_order_relaxed);
+    return b > t ? (int)(b - t) : 0;
+}
@@ -0,0 +1,62 @@
+#ifndef WS_DEQUE_H
+#define WS_DEQUE_H
+
+#include <stdbool.h>
+
+/**
+ * Chase-Lev work-stealing deque of pointers.
+ *
+ * One owner thread pushes and pops at the back (LIFO, no atomic
+ * read-modify-write except when taking the last element); any number of
+ * thieves steal from the front (FIFO) with a CAS on the front index. The
+ * storage is a power-of-two circular array that the owner doubles when it
+ * fills up. Retired arrays stay allocated until ws_deque_destroy, since a
+ * thief may still be reading one.
+ *
+ * Memory orderings follow Le, Pop, Cohen, Zappa Nardelli, "Correct and
+ * Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+typedef struct WsDeque WsDeque;
+
+/**
+ * Create an empty deque.
+ *
+ * @param initial_capacity  Rounded up to a power of two. Must be > 0.
+ *                          Returns NULL on error.
+ */
+WsDeque* ws_deque_create(int initial_capacity);
+
+/**
+ * Destroy the deque. No other thread may be using it.
+ */
+void ws_deque_destroy(WsDeque* dq);
+
+/**
+ * Owner only: push item (non-NULL) at the back, growing if needed.
+ *
+ * @return false if item is NULL or growing failed.
+ */
+bool ws_deque_push(WsDeque* dq, void* item);
+
+/**
+ * Owner only: pop the most recently pushed item.
+ *
+ * @return The item, or NULL if the deque is empty (or a thief took the
+ *         last one).
+ */
+void* ws_deque_pop(WsDeque* dq);
+
+/**
+ * Any thread: steal the oldest item.
+ *
+ * @return The item, or NULL if the deque was empty or another thread won
+ *         the race for it (try another victim).
+ */
+void* ws_deque_steal(WsDeque* dq);
+
+/**
+ * Approximate number of items (exact when only the owner is active).
+ */
+int ws_deque_size(const WsDeque* dq);
+
+#endif /* WS_DEQUE_H */
@@ -0,0 +1,251 @@
+#include "ws_pool.h"
+#include "ws_deque.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define WS_CACHE_LINE    64
+#define WS_DEQUE_INITIAL 256
+#define WS_SPIN_ROUNDS   64    // empty steal rounds before a worker sleeps
+
+typedef struct {
+    _Alignas(WS_CACHE_LINE)
+    WsDeque* dq;
+    WsPool*  pool;
+    uint32_t rng;              // victim selection
+    int      id;
+} WsWorker;
+
+struct WsPool {
+    int        threads;
+    WsWorker*  workers;        // threads entries, [0] is the creating thread
+    pthread_t* tids;           // threads - 1 entries
+    atomic_bool stop;
+    atomic_int  sleeping;      // workers inside ws_sleep
+    // sleep/wake: epoch changes (under lock) whenever sleepers should look again
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    unsigned        epoch;
+};
+
+static _Thread_local WsWorker* ws_self;
+
+static inline uint32_t ws_rand(WsWorker* w) {
+    uint32_t x = w->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return w->rng = x;
+}
+
+static void ws_run(WsTask* t) {
+    WsGroup* g = t->group;
+    t->fn(t->arg);
+    // t may be gone once the waiter sees the count drop: nothing after this
+    atomic_fetch_sub_explicit(&g->pending, 1, memory_order_release);
+}
+
+/* Own deque first (newest task, still warm in cache), then random victims. */
+static WsTask* ws_find(WsWorker* w) {
+    WsTask* t = ws_deque_pop(w->dq);
+    if (t) {
+        return t;
+    }
+    int n = w->pool->threads;
+    for (int i = 0; i < 2 * n && n > 1; ++i) {
+        int v = (int)(ws_rand(w) % (uint32_t)n);
+        if (v == w->id) continue;
+        t = ws_deque_steal(w->pool->workers[v].dq);
+        if (t) {
+            return t;
+        }
+    }
+    return NULL;
+}
+
+static bool ws_any_work(WsPool* p) {
+    for (int i = 0; i < p->threads; ++i) {
+        if (ws_deque_size(p->workers[i].dq) > 0) return true;
+    }
+    return false;
+}
+
+/* Sleep until a spawn (or stop) bumps the epoch. Announcing ourselves in
+ * sleeping before the last look at the deques pairs with ws_notify, which
+ * pushes before reading sleeping: one of the two sees the other. */
+static void ws_sleep(WsPool* p) {
+    pthread_mutex_lock(&p->lock);
+    unsigned epoch = p->epoch;
+    atomic_fetch_add_explicit(&p->sleeping, 1, memory_order_seq_cst);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!ws_any_work(p)) {
+        while (p->epoch == epoch && !atomic_load_explicit(&p->stop, memory_order_relaxed)) {
+            pthread_cond_wait(&p->wake, &p->lock);
+        }
+    }
+    atomic_fetch_sub_explicit(&p->sleeping, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void ws_notify(WsPool* p) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&p->sleeping, memory_order_relaxed) > 0) {
+        pthread_mutex_lock(&p->lock);
+        p->epoch++;
+        pthread_cond_signal(&p->wake);
+        pthread_mutex_unlock(&p->lock);
+    }
+}
+
+static void* ws_worker_main(void* arg) {
+    WsWorker* w = arg;
+    ws_self = w;
+    int idle = 0;
+    while (!atomic_load_explicit(&w->pool->stop, memory_order_acquire)) {
+        WsTask* t = ws_find(w);
+        if (t) {
+            ws_run(t);
+            idle = 0;
+        } else if (++idle < WS_SPIN_ROUNDS) {
+            sched_yield();
+        } else {
+            ws_sleep(w->pool);
+            idle = 0;
+        }
+    }
+    return NULL;
+}
+
+/* Stop and join the first `started` workers (0 is the caller) and free
+ * the first `made` deques. */
+static void ws_teardown(WsPool* p, int started, int made) {
+    atomic_store_explicit(&p->stop, true, memory_order_release);
+    pthread_mutex_lock(&p->lock);
+    p->epoch++;
+    pthread_cond_broadcast(&p->wake);
+    pthread_mutex_unlock(&p->lock);
+    for (int i = 1; i < started; ++i) {
+        pthread_join(p->tids[i - 1], NULL);
+    }
+    for (int i = 0; i < made; ++i) {
+        ws_deque_destroy(p->workers[i].dq);
+    }
+    pthread_cond_destroy(&p->wake);
+    pthread_mutex_destroy(&p->lock);
+    free(p->tids);
+    free(p->workers);
+    free(p);
+    ws_self = NULL;
+}
+
+WsPool* ws_pool_create(int threads) {
+    if (threads <= 0 || ws_self) {
+        return NULL;
+    }
+    WsPool* p = calloc(1, sizeof(WsPool));
+    if (!p) {
+        return NULL;
+    }
+    p->threads = threads;
+    p->workers = aligned_alloc(WS_CACHE_LINE, sizeof(WsWorker) * (size_t)threads);
+    p->tids = malloc(sizeof(pthread_t) * (size_t)threads);
+    if (!p->workers || !p->tids) {
+        free(p->workers);
+        free(p->tids);
+        free(p);
+        return NULL;
+    }
+    atomic_init(&p->stop, false);
+    atomic_init(&p->sleeping, 0);
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->wake, NULL);
+    p->epoch = 0;
+
+    int made = 0;
+    for (; made < threads; ++made) {
+        WsWorker* w = &p->workers[made];
+        w->dq = ws_deque_create(WS_DEQUE_INITIAL);
+        w->pool = p;
+        w->rng = 2654435761u * (uint32_t)(made + 1);
+        w->id = made;
+        if (!w->dq) break;
+    }
+    if (made < threads) {
+        ws_teardown(p, 1, made);
+        return NULL;
+    }
+    ws_self = &p->workers[0];
+    for (int started = 1; started < threads; ++started) {
+        if (pthread_create(&p->tids[started - 1], NULL, ws_worker_main, &p->workers[started]) != 0) {
+            ws_teardown(p, started, made);
+            return NULL;
+        }
+    }
+    return p;
+}
+
+void ws_pool_destroy(WsPool* pool) {
+    if (!pool) return;
+    ws_teardown(pool, pool->threads, pool->threads);
+}
+
+int ws_pool_threads(const WsPool* pool) {
+    return pool ? pool->threads : 0;
+}
+
+void ws_spawn(WsPool* pool, WsGroup* group, WsTask* task) {
+    WsWorker* w = ws_self;
+    atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+    task->group = group;
+    if (!w || w->pool != pool || !ws_deque_push(w->dq, task)) {
+        ws_run(task);               // not a worker of this pool, or out of memory: run it here
+        return;
+    }
+    ws_notify(pool);
+}
+
+void ws_wait(WsPool* pool, WsGroup* group) {
+    WsWorker* w = ws_self;
+    while (atomic_load_explicit(&group->pending, memory_order_acquire) != 0) {
+        WsTask* t = w && w->pool == pool ? ws_find(w) : NULL;
+        if (t) {
+            ws_run(t);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+typedef struct {
+    WsPool* pool;
+    size_t  begin, end, grain;
+    void  (*body)(size_t begin, size_t end, void* ctx);
+    void*   ctx;
+} WsRange;
+
+/* Split in halves: spawn the right one, recurse into the left, then wait. */
+static void ws_range_run(void* arg) {
+    WsRange* r = arg;
+    if (r->end - r->begin <= r->grain) {
+        r->body(r->begin, r->end, r->ctx);
+        return;
+    }
+    size_t mid = r->begin + (r->end - r->begin) / 2;
+    WsRange left = *r, right = *r;
+    left.end = mid;
+    right.begin = mid;
+    WsGroup g = WS_GROUP_INIT;
+    WsTask t = { ws_range_run, &right, NULL };
+    ws_spawn(r->pool, &g, &t);
+    ws_range_run(&left);
+    ws_wait(r->pool, &g);
+}
+
+void ws_parallel_for(WsPool* pool, size_t n, size_t grain,
+                     void (*body)(size_t begin, size_t end, void* ctx), void* ctx) {
+    if (!body || n == 0) return;
+    WsRange r = { pool, 0, n, grain ? grain : 1, body, ctx };
+    ws_range_run(&r);
+}
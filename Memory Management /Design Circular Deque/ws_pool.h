@@ -0,0 +1,75 @@
+#ifndef WS_POOL_H
+#define WS_POOL_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/**
+ * Small fork/join worker pool on top of WsDeque.
+ *
+ * Each worker owns a work-stealing deque. A spawned task goes onto the
+ * spawning worker's deque; idle workers steal from randomly chosen victims
+ * and, after a few empty rounds, sleep until new work is spawned.
+ *
+ * The thread that calls ws_pool_create is worker 0: it and code running
+ * inside tasks spawn onto the pool. A spawn from any other thread just
+ * runs the task on the spot.
+ *
+ * Tasks and groups are caller-owned memory (typically on the spawner's
+ * stack), so spawning does not allocate:
+ *
+ *     static void fib_task(void* arg) { ... }
+ *
+ *     WsGroup g = WS_GROUP_INIT;
+ *     WsTask left = { fib_task, &a };
+ *     ws_spawn(pool, &g, &left);
+ *     fib_task(&b);                  // do the other half here
+ *     ws_wait(pool, &g);             // helps run tasks until left is done
+ */
+typedef struct WsPool WsPool;
+
+typedef struct WsGroup {
+    atomic_int pending;             // spawned, not yet finished
+} WsGroup;
+
+#define WS_GROUP_INIT { 0 }
+
+typedef struct WsTask {
+    void (*fn)(void* arg);
+    void* arg;
+    WsGroup* group;                 // set by ws_spawn
+} WsTask;
+
+/**
+ * Start a pool of `threads` workers: the calling thread plus threads - 1
+ * new ones. Returns NULL on error.
+ */
+WsPool* ws_pool_create(int threads);
+
+/**
+ * Stop and join the workers. Call from worker 0 with no work pending.
+ */
+void ws_pool_destroy(WsPool* pool);
+
+int ws_pool_threads(const WsPool* pool);
+
+/**
+ * Queue task (which must stay valid until it has run) as part of group,
+ * on the calling worker's deque.
+ */
+void ws_spawn(WsPool* pool, WsGroup* group, WsTask* task);
+
+/**
+ * Run queued and stolen tasks until every task spawned into group has
+ * finished.
+ */
+void ws_wait(WsPool* pool, WsGroup* group);
+
+/**
+ * Call body(begin, end, ctx) over [0, n) in pieces of at most grain
+ * indices, split recursively across the pool. Returns when all are done.
+ */
+void ws_parallel_for(WsPool* pool, size_t n, size_t grain,
+                     void (*body)(size_t begin, size_t end, void* ctx), void* ctx);
+
+#endif /* WS_POOL_H */
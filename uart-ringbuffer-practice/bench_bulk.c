@@ -0,0 +1,79 @@
+// bench_bulk.c - consumer-side cost: per-byte ring_buffer_pop vs
+// ring_buffer_pop_n vs zero-copy peek/commit. Producer fills with push_n in
+// between, so only the drain is timed. The "parser" just sums the bytes.
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ringbuf.h"
+
+static ring_buffer_t rb;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t drain_per_byte(void) {
+    uint32_t sum = 0;
+    uint8_t b;
+    while (ring_buffer_pop(&rb, &b)) sum += b;
+    return sum;
+}
+
+static uint32_t drain_pop_n(void) {
+    uint8_t tmp[RING_BUFFER_SIZE];
+    uint32_t sum = 0, n;
+    while ((n = ring_buffer_pop_n(&rb, tmp, sizeof tmp)) != 0) {
+        for (uint32_t i = 0; i < n; ++i) sum += tmp[i];
+    }
+    return sum;
+}
+
+static uint32_t drain_peek_commit(void) {
+    ring_buffer_span_t span[2];
+    uint32_t sum = 0, n;
+    while ((n = ring_buffer_peek(&rb, span)) != 0) {
+        for (int s = 0; s < 2; ++s) {
+            for (uint32_t i = 0; i < span[s].len; ++i) sum += span[s].data[i];
+        }
+        ring_buffer_commit(&rb, n);
+    }
+    return sum;
+}
+
+static void run(const char *name, uint32_t (*drain)(void), uint64_t total, uint32_t chunk) {
+    uint8_t src[RING_BUFFER_SIZE];
+    for (uint32_t i = 0; i < sizeof src; ++i) src[i] = (uint8_t)i;
+
+    ring_buffer_init(&rb);
+    double spent = 0;
+    uint64_t moved = 0;
+    volatile uint32_t sink = 0;
+
+    while (moved < total) {
+        ring_buffer_push_n(&rb, src, chunk);
+        double t0 = now_sec();
+        sink += drain();
+        spent += now_sec() - t0;
+        moved += chunk;
+    }
+    (void)sink;
+    printf("%-12s chunk %3u: %8.1f MB/s  %6.2f ns/byte\n",
+           name, chunk, moved / spent / 1e6, spent * 1e9 / moved);
+}
+
+int main(int argc, char **argv) {
+    uint64_t total = argc > 1 ? strtoull(argv[1], NULL, 0) : 64u * 1000u * 1000u;
+    static const uint32_t chunks[] = { 8, 16, RING_BUFFER_SIZE / 2, RING_BUFFER_SIZE - 1 };
+
+    printf("ring size %u, %llu bytes per run\n", RING_BUFFER_SIZE, (unsigned long long)total);
+    for (size_t c = 0; c < sizeof chunks / sizeof chunks[0]; ++c) {
+        run("per-byte",    drain_per_byte,    total, chunks[c]);
+        run("pop_n",       drain_pop_n,       total, chunks[c]);
+        run("peek/commit", drain_peek_commit, total, chunks[c]);
+    }
+    return 0;
+}
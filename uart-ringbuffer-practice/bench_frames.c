@@ -0,0 +1,127 @@
+// bench_frames.c - frame decoding throughput: the old way (pop bytes one at a
+// time into a linear buffer, decode there) vs frame_decoder_process working
+// in place on the ring spans. A pre-encoded stream of random frames is pushed
+// in random-sized chunks so frames end mid-chunk and straddle the wrap; only
+// the consumer side is timed.
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "frame_codec.h"
+
+#define FRAME_RX_SIZE 4096u
+
+#define RB_NAME    frame_rx
+#define RB_SIZE    FRAME_RX_SIZE
+#define RB_INDEX_T uint16_t
+#include "ringbuf_template.h"
+#define RB_NAME    frame_rx
+#define RB_SIZE    FRAME_RX_SIZE
+#define RB_INDEX_T uint16_t
+#define RB_DEFINE
+#include "ringbuf_template.h"
+
+#define STREAM_FRAMES 20000u
+#define MIN_PAYLOAD   16u
+#define MAX_PAYLOAD   240u
+
+static frame_rx_t rx;
+static uint8_t    stream[STREAM_FRAMES * (2u * (MAX_PAYLOAD + 2u) + 1u)];
+static uint8_t    linear[FRAME_MAX_ENCODED + 1u];
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t rng = 12345u;
+static uint32_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+// The application's handler: touch every payload byte
+static void on_frame(void *ctx, const uint8_t *payload, uint32_t len) {
+    uint32_t *sum = ctx;
+    for (uint32_t i = 0; i < len; ++i) *sum += payload[i];
+}
+
+static uint32_t build_stream(frame_codec_t codec) {
+    uint8_t p[MAX_PAYLOAD];
+    uint32_t len = 0;
+    rng = 12345u;
+    for (uint32_t k = 0; k < STREAM_FRAMES; ++k) {
+        uint32_t n = MIN_PAYLOAD + next_rand() % (MAX_PAYLOAD - MIN_PAYLOAD + 1u);
+        for (uint32_t i = 0; i < n; ++i) p[i] = (uint8_t)next_rand();
+        len += frame_encode(codec, p, n, stream + len, sizeof stream - len);
+    }
+    return len;
+}
+
+// Old path: per-byte pop into a linear buffer, decode once the delimiter shows up
+static void drain_pop_linear(frame_decoder_t *fd, uint8_t delim) {
+    static uint32_t fill;
+    uint8_t b;
+    while (frame_rx_pop(&rx, &b)) {
+        if (fill < sizeof linear) linear[fill++] = b;
+        if (b != delim) continue;
+        ring_buffer_span_t span[2] = { { linear, fill }, { linear, 0 } };
+        frame_decoder_process(fd, span, sizeof linear);
+        fill = 0;
+    }
+}
+
+static void drain_in_place(frame_decoder_t *fd, uint8_t delim) {
+    ring_buffer_span_t span[2];
+    (void)delim;
+    if (frame_rx_peek(&rx, span) == 0) return;
+    frame_rx_commit(&rx, frame_decoder_process(fd, span, FRAME_RX_SIZE - 1u));
+}
+
+static void run(const char *name, frame_codec_t codec,
+                void (*drain)(frame_decoder_t *, uint8_t), uint32_t reps) {
+    uint32_t len = build_stream(codec);
+    uint8_t  delim = codec == FRAME_SLIP ? 0xC0u : 0x00u;
+    uint32_t sum = 0;
+    frame_decoder_t fd;
+    frame_decoder_init(&fd, codec, on_frame, &sum);
+    frame_rx_init(&rx);
+
+    double spent = 0;
+    for (uint32_t r = 0; r < reps; ++r) {
+        for (uint32_t off = 0; off < len; ) {
+            uint32_t chunk = 1u + next_rand() % 1024u;
+            if (chunk > len - off) chunk = len - off;
+            off += frame_rx_push_n(&rx, stream + off, chunk);
+            double t0 = now_sec();
+            drain(&fd, delim);
+            spent += now_sec() - t0;
+        }
+    }
+
+    if (fd.stats.frames != reps * STREAM_FRAMES || fd.stats.crc_errors || fd.stats.decode_errors) {
+        fprintf(stderr, "%s: decoded %u/%u frames, %u crc, %u decode errors\n", name,
+                fd.stats.frames, reps * STREAM_FRAMES, fd.stats.crc_errors, fd.stats.decode_errors);
+        exit(1);
+    }
+    printf("%-14s %s: %8.0f kframes/s  %7.1f MB/s payload  %7.1f MB/s wire  (sum %08x)\n",
+           name, codec == FRAME_SLIP ? "SLIP" : "COBS", fd.stats.frames / spent / 1e3,
+           fd.stats.bytes / spent / 1e6, (double)len * reps / spent / 1e6, sum);
+}
+
+int main(int argc, char **argv) {
+    uint32_t reps = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 20u;
+
+    printf("ring %u bytes, %u frames x %u reps, payload %u..%u bytes\n",
+           FRAME_RX_SIZE, STREAM_FRAMES, reps, MIN_PAYLOAD, MAX_PAYLOAD);
+    for (int c = 0; c < 2; ++c) {
+        frame_codec_t codec = c == 0 ? FRAME_SLIP : FRAME_COBS;
+        run("pop + linear", codec, drain_pop_linear, reps);
+        run("in place",     codec, drain_in_place,   reps);
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+// bench_linux.c - the Linux tty backend (uart_linux.c) echoing over a pty.
+//
+// The far end is the pty master: one thread writes a counting pattern,
+// another reads the echo back and checks it. The near end is the pty slave
+// driven through the normal uart_hal.h API (uart_rx_wait + uart_echo_task).
+// Reports throughput, the baud rate that would carry it (10 bits per byte)
+// and the backend's syscalls per KiB received.
+//
+// usage: bench_linux [total_bytes] [wake_level] [timeout_us]
+#define _DEFAULT_SOURCE
+#include <pthread.h>
+#include <pty.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "uart_linux.h"
+
+static int      master_fd;
+static uint64_t total = 256ull * 1024u * 1024u;
+static volatile int echo_done;
+static uint64_t errors;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void *far_writer(void *arg) {
+    static uint8_t chunk[65536];
+    (void)arg;
+    for (uint32_t i = 0; i < sizeof chunk; ++i) chunk[i] = (uint8_t)i;
+    // whole chunks of a multiple of 256 keep the pattern continuous
+    for (uint64_t sent = 0; sent < total; ) {
+        size_t n = total - sent < sizeof chunk ? (size_t)(total - sent) : sizeof chunk;
+        for (size_t off = 0; off < n; ) {
+            ssize_t w = write(master_fd, chunk + off, n - off);
+            if (w <= 0) return NULL;
+            off += (size_t)w;
+        }
+        sent += n;
+    }
+    return NULL;
+}
+
+static void *far_reader(void *arg) {
+    static uint8_t buf[65536];
+    (void)arg;
+    uint8_t expect = 0;
+    for (uint64_t got = 0; got < total; ) {
+        ssize_t n = read(master_fd, buf, sizeof buf);
+        if (n <= 0) break;
+        for (ssize_t i = 0; i < n; ++i) errors += buf[i] != expect++;
+        got += (uint64_t)n;
+    }
+    echo_done = 1;
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) total = strtoull(argv[1], NULL, 0);
+    uint32_t level   = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : RING_BUFFER_SIZE / 4u;
+    uint32_t timeout = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 0) : 1000u;
+
+    int slave_fd;
+    if (openpty(&master_fd, &slave_fd, NULL, NULL, NULL) != 0) {
+        perror("openpty");
+        return 1;
+    }
+    // raw on the master side too, so nothing is translated on the way back
+    struct termios tio;
+    tcgetattr(master_fd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(master_fd, TCSANOW, &tio);
+
+    if (uart_linux_attach(slave_fd, 0) != 0) {
+        perror("uart_linux_attach");
+        return 1;
+    }
+    uart_init();
+    uart_rx_set_wakeup(level, timeout);
+
+    pthread_t wr, rd;
+    double t0 = now_sec();
+    pthread_create(&rd, NULL, far_reader, NULL);
+    pthread_create(&wr, NULL, far_writer, NULL);
+    while (!echo_done) {
+        if (uart_rx_wait(100000u) == 0 && uart_tx_ring_is_empty(&uart_tx_buffer)) continue;
+        uart_echo_task();
+    }
+    double dt = now_sec() - t0;
+    pthread_join(wr, NULL);
+    pthread_join(rd, NULL);
+
+    const uart_linux_stats_t *s = &uart_linux_stats;
+    uint64_t calls = s->reads + s->writes + s->waits + s->ctls;
+    printf("rings rx %u / tx %u B, wake level %u B, timeout %u us, %llu B echoed\n",
+           RING_BUFFER_SIZE, UART_TX_BUFFER_SIZE, level, timeout, (unsigned long long)total);
+    printf("throughput : %.1f MB/s each way (%.1f Mbaud equivalent)\n",
+           total / dt / 1e6, total * 10.0 / dt / 1e6);
+    printf("syscalls   : %llu readv, %llu writev, %llu epoll_wait, %llu epoll_ctl\n",
+           (unsigned long long)s->reads, (unsigned long long)s->writes,
+           (unsigned long long)s->waits, (unsigned long long)s->ctls);
+    printf("per KiB    : %.3f syscalls, %.0f B per readv, %.0f B per writev\n",
+           calls / (s->rx_bytes / 1024.0), (double)s->rx_bytes / s->reads,
+           (double)s->tx_bytes / s->writes);
+    printf("errors     : %llu, rx overflow %u\n", (unsigned long long)errors,
+           uart_rx_buffer.overflow_count);
+    uart_linux_close();
+    close(master_fd);
+    return errors != 0;
+}
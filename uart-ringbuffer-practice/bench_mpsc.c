@@ -0,0 +1,135 @@
+// bench_mpsc.c - contention benchmark for the MPSC ring: 1..8 producer
+// threads push fixed-size records, the main thread drains. Baseline is
+// ring_buffer_t behind a pthread mutex (what you would do without the
+// lock-free reservation). "full" counts failed pushes that had to retry.
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ringbuf.h"
+#include "ringbuf_mpsc.h"
+
+#define MAX_PRODUCERS 8u
+#define RECORD_BYTES  16u
+
+static uint32_t total_records = 4u * 1000u * 1000u;
+
+static ring_buffer_mpsc_t rb_mpsc;
+static ring_buffer_t      rb_locked;
+static pthread_mutex_t    lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t           locked_full;
+
+typedef struct {
+    bool     (*push)(const uint8_t *rec);
+    uint32_t   records;
+    uint8_t    id;
+} producer_arg_t;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static bool push_mpsc(const uint8_t *rec) {
+    return ring_buffer_mpsc_push_n(&rb_mpsc, rec, RECORD_BYTES);
+}
+
+static uint32_t pop_mpsc(uint8_t *dst, uint32_t len) {
+    return ring_buffer_mpsc_pop_n(&rb_mpsc, dst, len);
+}
+
+// all-or-nothing like the MPSC push, so records stay whole
+static bool push_locked(const uint8_t *rec) {
+    bool ok = false;
+    pthread_mutex_lock(&lock);
+    if ((uint32_t)ring_buffer_level(&rb_locked) + RECORD_BYTES <= (uint32_t)RING_BUFFER_MASK) {
+        ok = ring_buffer_push_n(&rb_locked, rec, RECORD_BYTES) == RECORD_BYTES;
+    } else {
+        locked_full++;
+    }
+    pthread_mutex_unlock(&lock);
+    return ok;
+}
+
+static uint32_t pop_locked(uint8_t *dst, uint32_t len) {
+    pthread_mutex_lock(&lock);
+    uint32_t n = ring_buffer_pop_n(&rb_locked, dst, len);
+    pthread_mutex_unlock(&lock);
+    return n;
+}
+
+static void *producer(void *arg) {
+    producer_arg_t *pa = arg;
+    uint8_t rec[RECORD_BYTES];
+    memset(rec, pa->id, sizeof rec);
+    for (uint32_t seq = 0; seq < pa->records; ++seq) {
+        memcpy(rec + 1, &seq, sizeof seq);
+        while (!pa->push(rec)) sched_yield();
+    }
+    return NULL;
+}
+
+static void run(const char *name, uint32_t producers,
+                bool (*push)(const uint8_t *), uint32_t (*pop)(uint8_t *, uint32_t)) {
+    static uint8_t   drain[RING_BUFFER_SIZE];
+    pthread_t        t[MAX_PRODUCERS];
+    producer_arg_t   pa[MAX_PRODUCERS];
+    uint32_t         next[MAX_PRODUCERS] = {0}, errors = 0;
+    uint32_t         per = total_records / producers;
+    uint64_t         expect = (uint64_t)per * producers * RECORD_BYTES, got = 0;
+    uint32_t         carry = 0;
+    uint8_t          rec[RECORD_BYTES];
+
+    ring_buffer_mpsc_init(&rb_mpsc);
+    ring_buffer_init(&rb_locked);
+    locked_full = 0;
+
+    double t0 = now_sec();
+    for (uint32_t p = 0; p < producers; ++p) {
+        pa[p] = (producer_arg_t){ push, per, (uint8_t)p };
+        pthread_create(&t[p], NULL, producer, &pa[p]);
+    }
+    while (got < expect) {
+        uint32_t n = pop(drain, sizeof drain);
+        if (n == 0) {
+            sched_yield();
+            continue;
+        }
+        got += n;
+        // check each producer's sequence (records may straddle pop calls)
+        for (uint32_t i = 0; i < n; ++i) {
+            rec[carry++] = drain[i];
+            if (carry < RECORD_BYTES) continue;
+            uint32_t seq;
+            memcpy(&seq, rec + 1, sizeof seq);
+            if (rec[0] >= producers || seq != next[rec[0]]++) errors++;
+            carry = 0;
+        }
+    }
+    for (uint32_t p = 0; p < producers; ++p) pthread_join(t[p], NULL);
+    double dt = now_sec() - t0;
+
+    ring_buffer_status_t st;
+    ring_buffer_mpsc_get_status(&rb_mpsc, &st);
+    uint32_t full = push == push_mpsc ? st.overflow_count / RECORD_BYTES : locked_full;
+    printf("%-6s %u producer%s: %7.2f Mrec/s  %7.1f MB/s  full=%-9u errors=%u\n",
+           name, producers, producers == 1 ? " " : "s", per * producers / dt / 1e6,
+           expect / dt / 1e6, full, errors);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) total_records = (uint32_t)strtoul(argv[1], NULL, 0);
+
+    printf("ring size %u, %u-byte records, %u records per run\n",
+           RING_BUFFER_SIZE, RECORD_BYTES, total_records);
+    for (uint32_t p = 1; p <= MAX_PRODUCERS; p *= 2) {
+        run("mutex", p, push_locked, pop_locked);
+        run("mpsc",  p, push_mpsc,   pop_mpsc);
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+// bench_spsc.c - producer/consumer throughput: volatile ring_buffer_t vs the
+// lock-free SPSC variant. One producer thread, consumer on the main thread.
+//
+// Note: ring_buffer_t is only correct between an ISR and the code it
+// interrupts; across cores it happens to work on x86 (TSO) and is measured
+// here purely as the baseline.
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ringbuf.h"
+#include "ringbuf_spsc.h"
+
+static uint32_t total_bytes = 64u * 1000u * 1000u;
+
+static ring_buffer_t      rb_volatile;
+static ring_buffer_spsc_t rb_spsc;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void *volatile_producer(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < total_bytes; ++i) {
+        while (!ring_buffer_push(&rb_volatile, (uint8_t)i)) sched_yield();
+    }
+    return NULL;
+}
+
+static void *spsc_producer(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < total_bytes; ++i) {
+        while (!ring_buffer_spsc_push(&rb_spsc, (uint8_t)i)) sched_yield();
+    }
+    return NULL;
+}
+
+static void run(const char *name, void *(*producer)(void *),
+                bool (*pop)(void *, uint8_t *), void *rb) {
+    pthread_t t;
+    uint32_t errors = 0;
+    uint8_t b;
+
+    double t0 = now_sec();
+    pthread_create(&t, NULL, producer, NULL);
+    for (uint32_t i = 0; i < total_bytes; ++i) {
+        while (!pop(rb, &b)) sched_yield();
+        errors += (b != (uint8_t)i);
+    }
+    pthread_join(t, NULL);
+    double dt = now_sec() - t0;
+
+    printf("%-10s %8.1f MB/s  %6.2f ns/byte  errors=%u\n",
+           name, total_bytes / dt / 1e6, dt * 1e9 / total_bytes, errors);
+}
+
+static bool pop_volatile(void *rb, uint8_t *b) { return ring_buffer_pop(rb, b); }
+static bool pop_spsc(void *rb, uint8_t *b)     { return ring_buffer_spsc_pop(rb, b); }
+
+int main(int argc, char **argv) {
+    if (argc > 1) total_bytes = (uint32_t)strtoul(argv[1], NULL, 0);
+
+    printf("ring size %u, %u bytes per run\n", RING_BUFFER_SIZE, total_bytes);
+
+    ring_buffer_init(&rb_volatile);
+    run("volatile", volatile_producer, pop_volatile, &rb_volatile);
+
+    ring_buffer_spsc_init(&rb_spsc);
+    run("spsc", spsc_producer, pop_spsc, &rb_spsc);
+    return 0;
+}
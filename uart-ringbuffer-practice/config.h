@@ -1,9 +1,63 @@
 #pragma once
 
+#ifndef RING_BUFFER_SIZE                 // overridable with -D for host sizing runs
 #define RING_BUFFER_SIZE 64              // must be power of 2
+#endif
+
+// Narrowest index that holds RING_BUFFER_SIZE - 1
+#ifndef RING_BUFFER_INDEX_T
+# if RING_BUFFER_SIZE <= 256
+#  define RING_BUFFER_INDEX_T uint8_t
+# elif RING_BUFFER_SIZE <= 65536
+#  define RING_BUFFER_INDEX_T uint16_t
+# else
+#  define RING_BUFFER_INDEX_T uint32_t
+# endif
+#endif
+
 #define HIGH_WATERMARK   (RING_BUFFER_SIZE * 3 / 4)   // 75% (48)
 #define LOW_WATERMARK    (RING_BUFFER_SIZE / 4)       // 25% (16)
 
+// TX ring (interrupt-driven uart_write); always drops newest, uart_write
+// reports how much was queued.
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE 128          // must be power of 2
+#endif
+#ifndef UART_TX_INDEX_T
+# if UART_TX_BUFFER_SIZE <= 256
+#  define UART_TX_INDEX_T uint8_t
+# elif UART_TX_BUFFER_SIZE <= 65536
+#  define UART_TX_INDEX_T uint16_t
+# else
+#  define UART_TX_INDEX_T uint32_t
+# endif
+#endif
+
+// Consumer wakeup (uart_rx_wait): return once RX holds UART_RX_WAKE_LEVEL
+// bytes, or once the oldest unread byte has waited UART_RX_WAKE_TIMEOUT_US.
+// Both can be changed at run time with uart_rx_set_wakeup().
+#define UART_RX_WAKE_LEVEL      16
+#define UART_RX_WAKE_TIMEOUT_US 2000u
+
 // Overflow policy: default = drop newest.
 // Uncomment to overwrite oldest when full.
 // #define OVERWRITE_OLDEST
+
+// Instrumentation for the default ring: peak level, watermark trips and a
+// log2 histogram of push-to-pop latency (ring_buffer_stats). Compiled out
+// entirely when not defined. Costs a 32-bit stamp per slot when enabled.
+// #define RING_BUFFER_INSTRUMENT
+
+// Latency clock for the histogram; defaults to rdtsc (x86) or a ns clock on
+// the host. On target point it at a free-running counter:
+// #define RING_BUFFER_CYCLES() (DWT->CYCCNT)
+
+// Cache line size used to keep producer- and consumer-owned indices of the
+// SPSC ring (ringbuf_spsc.h) on separate lines. 64 on x86-64 and most ARMv8.
+#define RING_BUFFER_CACHE_LINE 64
+
+// Frame decoder (frame_codec.h): largest payload accepted, CRC excluded.
+// Bytes between delimiters beyond the SLIP worst case for this are dropped.
+#ifndef FRAME_MAX_PAYLOAD
+#define FRAME_MAX_PAYLOAD 256
+#endif
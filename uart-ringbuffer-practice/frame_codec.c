@@ -0,0 +1,225 @@
+#include "frame_codec.h"
+#include <string.h>
+
+#define SLIP_END     0xC0u
+#define SLIP_ESC     0xDBu
+#define SLIP_ESC_END 0xDCu
+#define SLIP_ESC_ESC 0xDDu
+
+// CRC-16/CCITT-FALSE: poly 0x1021, init 0xFFFF, no reflection
+static const uint16_t crc16_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+uint16_t frame_crc16(const uint8_t *data, uint32_t len) {
+    uint16_t crc = 0xFFFFu;
+    for (uint32_t i = 0; i < len; ++i) {
+        crc = (uint16_t)((crc << 8) ^ crc16_table[(uint8_t)((crc >> 8) ^ data[i])]);
+    }
+    return crc;
+}
+
+// In-place decoders: the write index never passes the read index.
+// Return the decoded length or -1 on a malformed frame.
+static int32_t slip_decode(uint8_t *buf, uint32_t len) {
+    const uint8_t *esc = memchr(buf, SLIP_ESC, len);
+    if (!esc) return (int32_t)len;            // common case: nothing to move
+
+    uint32_t w = (uint32_t)(esc - buf);
+    for (uint32_t r = w; r < len; ++r) {
+        uint8_t c = buf[r];
+        if (c == SLIP_ESC) {
+            if (++r == len) return -1;
+            if      (buf[r] == SLIP_ESC_END) c = SLIP_END;
+            else if (buf[r] == SLIP_ESC_ESC) c = SLIP_ESC;
+            else return -1;
+        }
+        buf[w++] = c;
+    }
+    return (int32_t)w;
+}
+
+static int32_t cobs_decode(uint8_t *buf, uint32_t len) {
+    uint32_t r = 0, w = 0;
+    while (r < len) {
+        uint8_t  code = buf[r++];
+        uint32_t run  = code - 1u;            // code 0 wraps and fails below
+        if (run > len - r) return -1;
+        memmove(buf + w, buf + r, run);
+        w += run;
+        r += run;
+        if (code != 0xFFu && r < len) buf[w++] = 0;
+    }
+    return (int32_t)w;
+}
+
+void frame_decoder_init(frame_decoder_t *fd, frame_codec_t codec,
+                        frame_handler_t on_frame, void *ctx) {
+    memset(fd, 0, sizeof *fd);
+    fd->codec    = codec;
+    fd->on_frame = on_frame;
+    fd->ctx      = ctx;
+}
+
+// Offset of the first delimiter at or after `from`, or avail if none.
+static uint32_t find_delim(const ring_buffer_span_t span[2], uint32_t from,
+                           uint32_t avail, uint8_t delim) {
+    if (from < span[0].len) {
+        const uint8_t *p = memchr(span[0].data + from, delim, span[0].len - from);
+        if (p) return (uint32_t)(p - span[0].data);
+        from = span[0].len;
+    }
+    const uint8_t *p = memchr(span[1].data + (from - span[0].len), delim, avail - from);
+    return p ? span[0].len + (uint32_t)(p - span[1].data) : avail;
+}
+
+static void deliver(frame_decoder_t *fd, const ring_buffer_span_t span[2],
+                    uint32_t off, uint32_t len) {
+    uint8_t *frame;
+    if (off + len <= span[0].len) {
+        frame = (uint8_t *)span[0].data + off;
+    } else if (off >= span[0].len) {
+        frame = (uint8_t *)span[1].data + (off - span[0].len);
+    } else {
+        // split by the wrap: the only copy
+        uint32_t first = span[0].len - off;
+        memcpy(fd->scratch, span[0].data + off, first);
+        memcpy(fd->scratch + first, span[1].data, len - first);
+        frame = fd->scratch;
+    }
+
+    int32_t n = fd->codec == FRAME_SLIP ? slip_decode(frame, len) : cobs_decode(frame, len);
+    if (n < 2) {
+        fd->stats.decode_errors++;
+        return;
+    }
+    uint32_t plen = (uint32_t)n - 2u;
+    if (plen > FRAME_MAX_PAYLOAD) {
+        fd->stats.oversize++;
+        return;
+    }
+    uint16_t crc = (uint16_t)((frame[plen] << 8) | frame[plen + 1u]);
+    if (crc != frame_crc16(frame, plen)) {
+        fd->stats.crc_errors++;
+        return;
+    }
+    fd->stats.frames++;
+    fd->stats.bytes += plen;
+    fd->on_frame(fd->ctx, frame, plen);
+}
+
+uint32_t frame_decoder_process(frame_decoder_t *fd, const ring_buffer_span_t span[2],
+                               uint32_t capacity) {
+    uint8_t  delim = fd->codec == FRAME_SLIP ? SLIP_END : 0x00u;
+    uint32_t avail = span[0].len + span[1].len;
+    uint32_t used  = 0;
+
+    while (used < avail) {
+        uint32_t end = find_delim(span, used + fd->scanned, avail, delim);
+        if (end == avail) {
+            // partial frame: keep it unless it can never complete
+            uint32_t pending = avail - used;
+            if (pending > FRAME_MAX_ENCODED || pending >= capacity) {
+                if (!fd->discarding) fd->stats.oversize++;
+                fd->discarding = true;
+                fd->scanned = 0;
+                return avail;
+            }
+            fd->scanned = pending;
+            break;
+        }
+
+        uint32_t len = end - used;
+        if (fd->discarding) {
+            fd->discarding = false;           // tail of a dropped frame
+        } else if (len > FRAME_MAX_ENCODED) {
+            fd->stats.oversize++;
+        } else if (len != 0) {                // back-to-back delimiters: nothing
+            deliver(fd, span, used, len);
+        }
+        used = end + 1u;
+        fd->scanned = 0;
+    }
+    return used;
+}
+
+uint32_t frame_decoder_poll(frame_decoder_t *fd, ring_buffer_t *rb) {
+    ring_buffer_span_t span[2];
+    uint32_t before = fd->stats.frames;
+    if (ring_buffer_peek(rb, span) == 0) return 0;
+    ring_buffer_commit(rb, frame_decoder_process(fd, span, RING_BUFFER_MASK));
+    return fd->stats.frames - before;
+}
+
+uint32_t frame_encode(frame_codec_t codec, const uint8_t *payload, uint32_t len,
+                      uint8_t *out, uint32_t out_cap) {
+    uint16_t crc = frame_crc16(payload, len);
+    uint8_t  trailer[2] = { (uint8_t)(crc >> 8), (uint8_t)crc };
+    uint32_t total = len + 2u, w = 0;
+
+    if (codec == FRAME_SLIP) {
+        for (uint32_t i = 0; i < total; ++i) {
+            uint8_t b = i < len ? payload[i] : trailer[i - len];
+            if (b == SLIP_END || b == SLIP_ESC) {
+                if (w + 2u > out_cap) return 0;
+                out[w++] = SLIP_ESC;
+                out[w++] = b == SLIP_END ? SLIP_ESC_END : SLIP_ESC_ESC;
+            } else {
+                if (w + 1u > out_cap) return 0;
+                out[w++] = b;
+            }
+        }
+        if (w + 1u > out_cap) return 0;
+        out[w++] = SLIP_END;
+        return w;
+    }
+
+    // COBS: one code byte per run of up to 254 non-zero bytes, plus delimiter
+    if (total + total / 254u + 2u > out_cap) return 0;
+    uint32_t code_at = w++;
+    uint8_t  code = 1;
+    for (uint32_t i = 0; i < total; ++i) {
+        uint8_t b = i < len ? payload[i] : trailer[i - len];
+        if (b != 0) {
+            out[w++] = b;
+            if (++code != 0xFFu) continue;
+        }
+        out[code_at] = code;
+        code_at = w++;
+        code = 1;
+    }
+    out[code_at] = code;
+    out[w++] = 0x00u;
+    return w;
+}
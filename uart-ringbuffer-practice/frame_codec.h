@@ -0,0 +1,70 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "ringbuf.h"
+
+// Streaming frame decoder layered on the ring's peek/commit.
+//
+// Wire format: encode(payload || CRC-16/CCITT-FALSE, big-endian) + delimiter
+//   FRAME_SLIP  RFC 1055 escaping, frame ends with 0xC0 (a leading 0xC0 is fine)
+//   FRAME_COBS  consistent overhead byte stuffing, frame ends with 0x00
+//
+// The decoder scans the readable spans for the delimiter, remembering how far
+// it got so partial arrivals are not rescanned. A complete frame that is
+// contiguous in the ring storage is decoded in place and handed to the
+// callback from there; only a frame split by the wrap is copied to scratch.
+// Decoding only ever moves bytes towards the start of the frame, inside the
+// region the consumer owns between peek and commit.
+//
+// Same rules as peek/commit: the producer must not touch unread bytes, so
+// use it on drop-newest rings (not with OVERWRITE_OLDEST or uart_init_dma).
+
+// Bytes between two delimiters: SLIP worst case for FRAME_MAX_PAYLOAD + CRC
+#define FRAME_MAX_ENCODED (2u * (FRAME_MAX_PAYLOAD + 2u))
+
+typedef enum {
+    FRAME_SLIP,
+    FRAME_COBS,
+} frame_codec_t;
+
+// payload points into the ring storage (or scratch) and is valid only for
+// the duration of the call.
+typedef void (*frame_handler_t)(void *ctx, const uint8_t *payload, uint32_t len);
+
+typedef struct {
+    uint32_t frames;          // delivered with a good CRC
+    uint32_t bytes;           // payload bytes delivered
+    uint32_t crc_errors;
+    uint32_t decode_errors;   // bad escape / COBS code, frame shorter than the CRC
+    uint32_t oversize;        // dropped: longer than FRAME_MAX_ENCODED or the ring
+} frame_stats_t;
+
+typedef struct {
+    frame_codec_t   codec;
+    frame_handler_t on_frame;
+    void           *ctx;
+    uint32_t        scanned;     // readable bytes already searched for a delimiter
+    bool            discarding;  // inside an oversize frame: skip to the next delimiter
+    frame_stats_t   stats;
+    uint8_t         scratch[FRAME_MAX_ENCODED];   // frames split by the wrap
+} frame_decoder_t;
+
+void frame_decoder_init(frame_decoder_t *fd, frame_codec_t codec,
+                        frame_handler_t on_frame, void *ctx);
+
+// Any ringbuf_template.h instance: pass what <name>_peek() filled in and the
+// instance capacity (RB_SIZE - 1), then <name>_commit() the return value.
+// Delivers every complete frame in the spans; the trailing partial frame
+// stays in the ring for the next call.
+uint32_t frame_decoder_process(frame_decoder_t *fd, const ring_buffer_span_t span[2],
+                               uint32_t capacity);
+
+// ring_buffer_t shortcut: peek, process, commit. Returns frames delivered.
+uint32_t frame_decoder_poll(frame_decoder_t *fd, ring_buffer_t *rb);
+
+// Encoder for the TX side and tests: writes encode(payload || crc) plus the
+// delimiter to out. Returns the encoded length, 0 if out_cap is too small.
+uint32_t frame_encode(frame_codec_t codec, const uint8_t *payload, uint32_t len,
+                      uint8_t *out, uint32_t out_cap);
+
+uint16_t frame_crc16(const uint8_t *data, uint32_t len);
@@ -4,6 +4,7 @@ int main(void) {
     uart_init();
 
     for (;;) {
+        uart_rx_wait(UART_RX_WAIT_FOREVER);  // sleep until a batch is ready
         uart_echo_task();     // drain RX -> TX (echo)
         uart_monitor_task();  // optional backpressure hook
         // ...other work...
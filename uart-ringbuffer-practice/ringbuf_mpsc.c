@@ -0,0 +1,209 @@
+#include "ringbuf_mpsc.h"
+#include <string.h>
+
+#define POS_MASK     0x00FFFFFFu          // positions are 24-bit, free-running
+#define SEQ_MASK     0xFFu                // reservation counts are 8-bit, wrapping
+#define SLOT_MASK    (RING_BUFFER_MPSC_SLOTS - 1u)
+#define NOT_READING  0xFFFFFFFFu          // `reading` while the consumer is idle
+
+_Static_assert(RING_BUFFER_SIZE <= (1u << 23), "MPSC positions are 24-bit");
+_Static_assert(RING_BUFFER_MPSC_SLOTS >= 2 && RING_BUFFER_MPSC_SLOTS <= 128 &&
+               (RING_BUFFER_MPSC_SLOTS & (RING_BUFFER_MPSC_SLOTS - 1)) == 0,
+               "RING_BUFFER_MPSC_SLOTS must be a power of 2 in 2..128");
+
+// resv, committed and done[] all pack pos << 8 | count
+static inline uint32_t word_pos(uint32_t w) { return w >> 8; }
+static inline uint32_t word_seq(uint32_t w) { return w & SEQ_MASK; }
+static inline uint32_t dist(uint32_t from, uint32_t to) { return (to - from) & POS_MASK; }
+
+void ring_buffer_mpsc_init(ring_buffer_mpsc_t *rb) {
+    atomic_store_explicit(&rb->resv, 0u, memory_order_relaxed);
+    atomic_store_explicit(&rb->committed, 0u, memory_order_relaxed);
+    atomic_store_explicit(&rb->overflow_count, 0u, memory_order_relaxed);
+    // as if reservation i - SLOTS had committed: not done for count i
+    for (uint32_t i = 0; i < RING_BUFFER_MPSC_SLOTS; ++i) {
+        atomic_store_explicit(&rb->done[i], (i - RING_BUFFER_MPSC_SLOTS) & SEQ_MASK,
+                              memory_order_relaxed);
+    }
+    atomic_store_explicit(&rb->tail, 0u, memory_order_relaxed);
+#ifdef OVERWRITE_OLDEST
+    atomic_store_explicit(&rb->reading, NOT_READING, memory_order_relaxed);
+#endif
+    atomic_store_explicit(&rb->high_wm_flag, false, memory_order_relaxed);
+}
+
+uint32_t ring_buffer_mpsc_level(const ring_buffer_mpsc_t *rb) {
+    uint32_t t = atomic_load_explicit(&rb->tail, memory_order_acquire);
+    uint32_t c = atomic_load_explicit(&rb->committed, memory_order_acquire);
+    return dist(t, word_pos(c));
+}
+
+static void drop(ring_buffer_mpsc_t *rb, uint32_t n) {
+    atomic_fetch_add_explicit(&rb->overflow_count, n, memory_order_relaxed);
+}
+
+bool ring_buffer_mpsc_reserve(ring_buffer_mpsc_t *rb, uint32_t n, ring_buffer_mpsc_resv_t *r) {
+    uint32_t w, head;
+
+    if (n == 0 || n > RING_BUFFER_SIZE) {
+        drop(rb, n);
+        return false;
+    }
+    for (;;) {
+        // tail first: tail <= committed <= any later reserve position
+        // (seq_cst: pairs with the consumer's `reading` store, see below)
+        uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_seq_cst);
+        uint32_t c = atomic_load_explicit(&rb->committed, memory_order_acquire);
+        w = atomic_load_explicit(&rb->resv, memory_order_relaxed);
+        head = word_pos(w);
+
+        if (((word_seq(w) - word_seq(c)) & SEQ_MASK) >= RING_BUFFER_MPSC_SLOTS) {
+            drop(rb, n);                // too many open reservations
+            return false;
+        }
+        if (dist(tail, head) + n > RING_BUFFER_SIZE) {
+#ifdef OVERWRITE_OLDEST
+            // evict only committed bytes; open ranges belong to someone
+            uint32_t new_tail = (head + n - RING_BUFFER_SIZE) & POS_MASK;
+            if (dist(tail, new_tail) <= dist(tail, word_pos(c))) {
+                if (atomic_compare_exchange_weak_explicit(&rb->tail, &tail, new_tail,
+                                                          memory_order_seq_cst,
+                                                          memory_order_relaxed)) {
+                    drop(rb, dist(tail, new_tail));
+                }
+                continue;
+            }
+#endif
+            drop(rb, n);
+            return false;
+        }
+#ifdef OVERWRITE_OLDEST
+        // never hand out bytes the consumer is copying: it stored `reading`
+        // before re-checking tail, we loaded tail before `reading`, so one of
+        // us sees the other (all seq_cst)
+        uint32_t rd = atomic_load_explicit(&rb->reading, memory_order_seq_cst);
+        if (rd != NOT_READING && dist(rd, head + n) > RING_BUFFER_SIZE) {
+            if (atomic_load_explicit(&rb->resv, memory_order_relaxed) != w) continue;  // stale head
+            drop(rb, n);
+            return false;
+        }
+#endif
+
+        uint32_t next = ((head + n) & POS_MASK) << 8 | ((word_seq(w) + 1u) & SEQ_MASK);
+        if (atomic_compare_exchange_weak_explicit(&rb->resv, &w, next,
+                                                  memory_order_acquire,
+                                                  memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    uint32_t idx   = head & RING_BUFFER_MASK;
+    uint32_t first = RING_BUFFER_SIZE - idx;
+    if (first > n) first = n;
+    r->data[0] = rb->buffer + idx;
+    r->len[0]  = first;
+    r->data[1] = rb->buffer;
+    r->len[1]  = n - first;
+    r->tag     = ((head + n) & POS_MASK) << 8 | word_seq(w);
+    return true;
+}
+
+// Move `committed` over every done reservation at the front. Anyone may
+// do it; the seq_cst store of done[] and load of committed in commit, and
+// the seq_cst CAS of committed and load of done[] here, make sure that the
+// last of two racing committers sees the other's reservation done.
+static void publish(ring_buffer_mpsc_t *rb) {
+    uint32_t c = atomic_load_explicit(&rb->committed, memory_order_seq_cst);
+    for (;;) {
+        uint32_t d = atomic_load_explicit(&rb->done[word_seq(c) & SLOT_MASK], memory_order_seq_cst);
+        if (word_seq(d) != word_seq(c)) return;     // oldest open range not committed yet
+        uint32_t next = (d & ~SEQ_MASK) | ((word_seq(c) + 1u) & SEQ_MASK);
+        if (atomic_compare_exchange_weak_explicit(&rb->committed, &c, next,
+                                                  memory_order_seq_cst,
+                                                  memory_order_seq_cst)) {
+            c = next;
+        }
+    }
+}
+
+void ring_buffer_mpsc_commit(ring_buffer_mpsc_t *rb, const ring_buffer_mpsc_resv_t *r) {
+    // release (and seq_cst, see publish): our bytes are visible to whoever
+    // sees the slot done
+    atomic_store_explicit(&rb->done[word_seq(r->tag) & SLOT_MASK], r->tag, memory_order_seq_cst);
+    publish(rb);
+
+    // watermark set (upward cross)
+    if (!atomic_load_explicit(&rb->high_wm_flag, memory_order_relaxed) &&
+        ring_buffer_mpsc_level(rb) >= HIGH_WATERMARK) {
+        atomic_store_explicit(&rb->high_wm_flag, true, memory_order_relaxed);
+    }
+}
+
+bool ring_buffer_mpsc_push_n(ring_buffer_mpsc_t *rb, const uint8_t *src, uint32_t n) {
+    ring_buffer_mpsc_resv_t r;
+    if (!ring_buffer_mpsc_reserve(rb, n, &r)) return false;
+    memcpy(r.data[0], src, r.len[0]);
+    memcpy(r.data[1], src + r.len[0], r.len[1]);
+    ring_buffer_mpsc_commit(rb, &r);
+    return true;
+}
+
+bool ring_buffer_mpsc_push(ring_buffer_mpsc_t *rb, uint8_t data) {
+    return ring_buffer_mpsc_push_n(rb, &data, 1);
+}
+
+uint32_t ring_buffer_mpsc_pop_n(ring_buffer_mpsc_t *rb, uint8_t *dst, uint32_t len) {
+    uint32_t t, n;
+    for (;;) {
+        t = atomic_load_explicit(&rb->tail, memory_order_acquire);
+#ifdef OVERWRITE_OLDEST
+        // announce where we copy from, then make sure no producer evicted
+        // in between: from here on producers leave [t, t + size) alone
+        atomic_store_explicit(&rb->reading, t, memory_order_seq_cst);
+        if (atomic_load_explicit(&rb->tail, memory_order_seq_cst) != t) continue;
+#endif
+        uint32_t c = atomic_load_explicit(&rb->committed, memory_order_acquire);
+        n = dist(t, word_pos(c));
+        if (n > len) n = len;
+
+        uint32_t idx   = t & RING_BUFFER_MASK;
+        uint32_t first = RING_BUFFER_SIZE - idx;
+        if (first > n) first = n;
+        memcpy(dst, rb->buffer + idx, first);
+        memcpy(dst + first, rb->buffer, n - first);
+
+#ifdef OVERWRITE_OLDEST
+        // the copy is intact, but a producer may have evicted part of it
+        // meanwhile (already counted as overflow): then start over from
+        // the new tail
+        atomic_store_explicit(&rb->reading, NOT_READING, memory_order_release);
+        if (n == 0 ||
+            atomic_compare_exchange_strong_explicit(&rb->tail, &t, (t + n) & POS_MASK,
+                                                    memory_order_acq_rel,
+                                                    memory_order_relaxed)) {
+            break;
+        }
+#else
+        atomic_store_explicit(&rb->tail, (t + n) & POS_MASK, memory_order_release);
+        break;
+#endif
+    }
+
+    // watermark clear (downward cross)
+    if (n != 0 && atomic_load_explicit(&rb->high_wm_flag, memory_order_relaxed) &&
+        ring_buffer_mpsc_level(rb) <= LOW_WATERMARK) {
+        atomic_store_explicit(&rb->high_wm_flag, false, memory_order_relaxed);
+    }
+    return n;
+}
+
+bool ring_buffer_mpsc_pop(ring_buffer_mpsc_t *rb, uint8_t *data) {
+    return ring_buffer_mpsc_pop_n(rb, data, 1) == 1u;
+}
+
+void ring_buffer_mpsc_get_status(const ring_buffer_mpsc_t *rb, ring_buffer_status_t *st) {
+    st->level = ring_buffer_mpsc_level(rb);
+    st->overflow_count = atomic_load_explicit(&rb->overflow_count, memory_order_relaxed);
+    st->high_wm_active = atomic_load_explicit(&rb->high_wm_flag, memory_order_relaxed);
+    st->utilization_percent = (uint8_t)((st->level * 100u) / RING_BUFFER_SIZE);
+}
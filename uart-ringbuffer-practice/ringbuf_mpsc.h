@@ -0,0 +1,87 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ringbuf.h"
+
+#ifndef RING_BUFFER_MPSC_SLOTS
+#define RING_BUFFER_MPSC_SLOTS 16        // open reservations at once, power of 2, 2..128
+#endif
+
+// Multi-producer/single-consumer variant for feeding one ring (logging,
+// aggregation) from several UART ISRs, a timer ISR or several threads.
+//
+// Producers reserve a byte range, fill it, then commit it. Reservation is a
+// CAS loop on one 32-bit word that packs the reserve position (24-bit,
+// free-running) with a count of reservations made (8-bit, wrapping). Each
+// commit marks its reservation done in a small slot table and then moves
+// `committed` forward over every done reservation at the front: whoever
+// commits the oldest open range publishes it together with any later ones
+// already done. Nobody ever waits for another producer, so a high-priority
+// ISR that preempts a half-written reservation cannot deadlock on it.
+//
+// The consumer sees bytes up to `committed`, which is always an in-order
+// prefix: a range committed out of order becomes visible as soon as the
+// ranges reserved before it are committed, however busy the other
+// producers are. At most RING_BUFFER_MPSC_SLOTS reservations can be open at
+// once; a reserve beyond that fails like a full ring. A reservation's bytes
+// are contiguous in the stream and never interleave with another
+// producer's.
+//
+// Positions are free-running, so all RING_BUFFER_SIZE bytes are usable.
+// Overflow policy follows config.h:
+//   default           reservation fails, overflow_count += requested bytes
+//   OVERWRITE_OLDEST  producer moves tail past committed bytes to make room,
+//                     overflow_count += evicted bytes; it still fails if
+//                     the room is held by open reservations, or by the
+//                     bytes the consumer is copying out right now (the
+//                     consumer announces them in `reading`, so the two
+//                     never touch the same bytes at once). The consumer
+//                     then validates each read with a CAS on tail and
+//                     retries when a producer evicted under it.
+//
+// Target: needs LDREX/STREX (Cortex-M3 and up). On M0 the C11 atomics fall
+// back to the toolchain's IRQ-masking helpers.
+
+typedef struct {
+    // producer-owned line
+    _Alignas(RING_BUFFER_CACHE_LINE) _Atomic uint32_t resv;   // pos << 8 | reserved count
+    _Atomic uint32_t committed;         // published pos << 8 | published count
+    _Atomic uint32_t overflow_count;
+    _Atomic uint32_t done[RING_BUFFER_MPSC_SLOTS];  // end pos << 8 | count, per reservation
+
+    // consumer-owned line (producers CAS it only under OVERWRITE_OLDEST)
+    _Alignas(RING_BUFFER_CACHE_LINE) _Atomic uint32_t tail;
+#ifdef OVERWRITE_OLDEST
+    _Atomic uint32_t reading;           // tail being copied from, or ~0u
+#endif
+
+    // set by producers (upward cross), cleared by consumer (downward cross)
+    _Alignas(RING_BUFFER_CACHE_LINE) _Atomic bool high_wm_flag;
+
+    _Alignas(RING_BUFFER_CACHE_LINE) uint8_t buffer[RING_BUFFER_SIZE];
+} ring_buffer_mpsc_t;
+
+// A reserved range: up to two writable spans (before and after the wrap).
+typedef struct {
+    uint8_t *data[2];
+    uint32_t len[2];
+    uint32_t tag;                       // for commit: end pos << 8 | count
+} ring_buffer_mpsc_resv_t;
+
+void     ring_buffer_mpsc_init(ring_buffer_mpsc_t *rb);
+
+// Producers (any ISR priority / thread). reserve returns false when the
+// range is dropped; every successful reserve must be committed, with the
+// same r, by the producer that made it.
+bool     ring_buffer_mpsc_reserve(ring_buffer_mpsc_t *rb, uint32_t n, ring_buffer_mpsc_resv_t *r);
+void     ring_buffer_mpsc_commit (ring_buffer_mpsc_t *rb, const ring_buffer_mpsc_resv_t *r);
+bool     ring_buffer_mpsc_push   (ring_buffer_mpsc_t *rb, uint8_t data);
+bool     ring_buffer_mpsc_push_n (ring_buffer_mpsc_t *rb, const uint8_t *src, uint32_t n);  // all or nothing
+
+// Consumer
+uint32_t ring_buffer_mpsc_pop_n  (ring_buffer_mpsc_t *rb, uint8_t *dst, uint32_t len);
+bool     ring_buffer_mpsc_pop    (ring_buffer_mpsc_t *rb, uint8_t *data);
+
+uint32_t ring_buffer_mpsc_level(const ring_buffer_mpsc_t *rb);          // committed bytes, approximate
+void     ring_buffer_mpsc_get_status(const ring_buffer_mpsc_t *rb, ring_buffer_status_t *st);
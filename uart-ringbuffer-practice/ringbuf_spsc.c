@@ -0,0 +1,82 @@
+#include "ringbuf_spsc.h"
+
+#ifdef OVERWRITE_OLDEST
+# warning "ring_buffer_spsc_t always drops newest; OVERWRITE_OLDEST is ignored"
+#endif
+
+void ring_buffer_spsc_init(ring_buffer_spsc_t *rb) {
+    atomic_store_explicit(&rb->head, 0u, memory_order_relaxed);
+    atomic_store_explicit(&rb->tail, 0u, memory_order_relaxed);
+    atomic_store_explicit(&rb->overflow_count, 0u, memory_order_relaxed);
+    atomic_store_explicit(&rb->high_wm_flag, false, memory_order_relaxed);
+    rb->tail_cache = 0;
+    rb->head_cache = 0;
+}
+
+uint32_t ring_buffer_spsc_level(const ring_buffer_spsc_t *rb) {
+    uint32_t h = atomic_load_explicit(&rb->head, memory_order_acquire);
+    uint32_t t = atomic_load_explicit(&rb->tail, memory_order_acquire);
+    return (h - t) & RING_BUFFER_MASK;
+}
+
+bool ring_buffer_spsc_push(ring_buffer_spsc_t *rb, uint8_t data) {
+    // head is ours: relaxed load is enough
+    uint32_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    uint32_t next_head = (head + 1u) & RING_BUFFER_MASK;
+
+    if (next_head == rb->tail_cache) {
+        // looks full with the cached tail; refresh before giving up
+        rb->tail_cache = atomic_load_explicit(&rb->tail, memory_order_acquire);
+        if (next_head == rb->tail_cache) {
+            uint32_t n = atomic_load_explicit(&rb->overflow_count, memory_order_relaxed);
+            atomic_store_explicit(&rb->overflow_count, n + 1u, memory_order_relaxed);
+            return false; // drop newest
+        }
+    }
+
+    rb->buffer[head] = data;
+    atomic_store_explicit(&rb->head, next_head, memory_order_release);
+
+    // watermark set (upward cross). The cached tail can only overestimate the
+    // level, so confirm against the real tail before raising the flag.
+    if (!atomic_load_explicit(&rb->high_wm_flag, memory_order_relaxed) &&
+        ((next_head - rb->tail_cache) & RING_BUFFER_MASK) >= HIGH_WATERMARK) {
+        rb->tail_cache = atomic_load_explicit(&rb->tail, memory_order_acquire);
+        if (((next_head - rb->tail_cache) & RING_BUFFER_MASK) >= HIGH_WATERMARK) {
+            atomic_store_explicit(&rb->high_wm_flag, true, memory_order_relaxed);
+        }
+    }
+    return true;
+}
+
+bool ring_buffer_spsc_pop(ring_buffer_spsc_t *rb, uint8_t *data) {
+    uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+
+    if (tail == rb->head_cache) {
+        // looks empty with the cached head; refresh
+        rb->head_cache = atomic_load_explicit(&rb->head, memory_order_acquire);
+        if (tail == rb->head_cache) return false;
+    }
+
+    *data = rb->buffer[tail];
+    uint32_t next_tail = (tail + 1u) & RING_BUFFER_MASK;
+    atomic_store_explicit(&rb->tail, next_tail, memory_order_release);
+
+    // watermark clear (downward cross). The cached head underestimates the
+    // level; re-read it so a burst in flight does not clear the flag early.
+    if (atomic_load_explicit(&rb->high_wm_flag, memory_order_relaxed) &&
+        ((rb->head_cache - next_tail) & RING_BUFFER_MASK) <= LOW_WATERMARK) {
+        rb->head_cache = atomic_load_explicit(&rb->head, memory_order_acquire);
+        if (((rb->head_cache - next_tail) & RING_BUFFER_MASK) <= LOW_WATERMARK) {
+            atomic_store_explicit(&rb->high_wm_flag, false, memory_order_relaxed);
+        }
+    }
+    return true;
+}
+
+void ring_buffer_spsc_get_status(const ring_buffer_spsc_t *rb, ring_buffer_status_t *st) {
+    st->level = ring_buffer_spsc_level(rb);
+    st->overflow_count = atomic_load_explicit(&rb->overflow_count, memory_order_relaxed);
+    st->high_wm_active = atomic_load_explicit(&rb->high_wm_flag, memory_order_relaxed);
+    st->utilization_percent = (uint8_t)((st->level * 100u) / RING_BUFFER_SIZE);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ringbuf.h"
+
+// Lock-free SPSC variant of ring_buffer_t for producer/consumer running on
+// different cores (threads on Linux, or an ISR and a task on SMP parts).
+//
+// Same layout rules as ring_buffer_t: RING_BUFFER_SIZE slots, one kept empty,
+// drop-newest on overflow. OVERWRITE_OLDEST is not supported here: it would
+// make the producer write `tail`, and then it is no longer single-writer.
+//
+// Ordering contract:
+//   producer: store data, then store head with release
+//   consumer: load head with acquire, read data, then store tail with release
+// Each side keeps a cached copy of the opposite index and only re-reads the
+// shared one when the cached value says full/empty.
+
+typedef struct {
+    // producer-owned line
+    _Alignas(RING_BUFFER_CACHE_LINE) _Atomic uint32_t head;
+    uint32_t tail_cache;                // producer's last view of tail
+    _Atomic uint32_t overflow_count;    // written by producer only
+
+    // consumer-owned line
+    _Alignas(RING_BUFFER_CACHE_LINE) _Atomic uint32_t tail;
+    uint32_t head_cache;                // consumer's last view of head
+
+    // set by producer (upward cross), cleared by consumer (downward cross)
+    _Alignas(RING_BUFFER_CACHE_LINE) _Atomic bool high_wm_flag;
+
+    _Alignas(RING_BUFFER_CACHE_LINE) uint8_t buffer[RING_BUFFER_SIZE];
+} ring_buffer_spsc_t;
+
+void     ring_buffer_spsc_init(ring_buffer_spsc_t *rb);
+bool     ring_buffer_spsc_push(ring_buffer_spsc_t *rb, uint8_t data);    // producer
+bool     ring_buffer_spsc_pop (ring_buffer_spsc_t *rb, uint8_t *data);   // consumer
+uint32_t ring_buffer_spsc_level(const ring_buffer_spsc_t *rb);           // any thread, approximate
+void     ring_buffer_spsc_get_status(const ring_buffer_spsc_t *rb, ring_buffer_status_t *st);
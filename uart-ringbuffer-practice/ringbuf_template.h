@@ -0,0 +1,431 @@
+// ringbuf_template.h - generates a ring buffer type + API per instance.
+//
+// No include guard on purpose: include once per instance. Parameters:
+//
+//   RB_NAME             prefix, e.g. uart_hs_rx -> uart_hs_rx_t, uart_hs_rx_push()
+//   RB_SIZE             capacity in bytes, power of 2 (one slot stays empty)
+//   RB_INDEX_T          uint8_t / uint16_t / uint32_t, must hold RB_SIZE - 1
+//   RB_HIGH_WATERMARK   optional, default 75% of RB_SIZE
+//   RB_LOW_WATERMARK    optional, default 25% of RB_SIZE
+//   RB_OVERWRITE_OLDEST optional, define for overwrite-oldest (default drop newest)
+//   RB_INSTRUMENT       optional, define to track peak level, watermark trips and
+//                       a push-to-pop latency histogram (see RB_FN(stats))
+//   RB_DEFINE           define in exactly one .c to emit the function bodies
+//
+// Header side (type + prototypes):
+//
+//   #define RB_NAME    uart_hs_rx
+//   #define RB_SIZE    4096
+//   #define RB_INDEX_T uint16_t
+//   #include "ringbuf_template.h"
+//
+// Source side: the same parameters plus RB_DEFINE. All parameters are
+// #undef'd at the end, so instances can be stacked back to back.
+//
+// Small instances keep byte-wide indices, so the code for a 64-byte ring is
+// the same as the hand-written uint8_t version: no runtime cost for the
+// generic form.
+
+#ifndef RINGBUF_TEMPLATE_COMMON
+#define RINGBUF_TEMPLATE_COMMON
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <string.h>
+
+typedef struct {
+    uint32_t level;                // 0..size-1
+    uint32_t overflow_count;
+    bool     high_wm_active;
+    uint8_t  utilization_percent;  // 0..100
+} ring_buffer_status_t;
+
+// Contiguous run of readable bytes inside the ring storage. A readable region
+// is at most two spans (before and after the wrap).
+typedef struct {
+    const uint8_t *data;
+    uint32_t       len;
+} ring_buffer_span_t;
+
+// Same for the free space on the producer side (reserve/publish).
+typedef struct {
+    uint8_t  *data;
+    uint32_t  len;
+} ring_buffer_wspan_t;
+
+// Instrumentation snapshot (all zero for instances built without RB_INSTRUMENT).
+// lat_hist[k] counts bytes that sat in the ring for [2^(k-1), 2^k) ticks of
+// RING_BUFFER_CYCLES(); lat_hist[0] counts zero-tick latencies.
+#define RING_BUFFER_LAT_BUCKETS 32
+
+typedef struct {
+    uint32_t peak_level;           // highest level since last reset
+    uint32_t wm_trips;             // upward HIGH_WATERMARK crossings
+    uint32_t lat_samples;          // bytes timed
+    uint32_t lat_hist[RING_BUFFER_LAT_BUCKETS];
+} ring_buffer_stats_t;
+
+// Cycle-counter hook for latency stamps (only read by instrumented instances).
+// Define it before this header to use the MCU's counter, e.g. DWT->CYCCNT.
+#ifndef RING_BUFFER_CYCLES
+# if defined(__x86_64__) || defined(__i386__)
+#  define RING_BUFFER_CYCLES() ((uint32_t)__builtin_ia32_rdtsc())
+# else
+#  include <time.h>
+static inline uint32_t ring_buffer_host_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#  define RING_BUFFER_CYCLES() ring_buffer_host_ns()
+# endif
+#endif
+
+#define RB_CAT_(a, b) a##b
+#define RB_CAT(a, b)  RB_CAT_(a, b)
+#endif // RINGBUF_TEMPLATE_COMMON
+
+#if !defined(RB_NAME) || !defined(RB_SIZE) || !defined(RB_INDEX_T)
+# error "define RB_NAME, RB_SIZE and RB_INDEX_T before including ringbuf_template.h"
+#endif
+#if (RB_SIZE & (RB_SIZE - 1)) != 0
+# error "RB_SIZE must be a power of 2"
+#endif
+#ifndef RB_HIGH_WATERMARK
+# define RB_HIGH_WATERMARK (RB_SIZE * 3 / 4)
+#endif
+#ifndef RB_LOW_WATERMARK
+# define RB_LOW_WATERMARK  (RB_SIZE / 4)
+#endif
+
+#define RB_T      RB_CAT(RB_NAME, _t)
+#define RB_FN(fn) RB_CAT(RB_NAME, _##fn)
+#define RB_MASK   ((RB_INDEX_T)(RB_SIZE - 1u))
+
+#ifndef RB_DEFINE
+
+_Static_assert((RB_SIZE - 1u) <= (RB_INDEX_T)~(RB_INDEX_T)0,
+               "RB_INDEX_T too narrow for RB_SIZE");
+
+typedef struct {
+    volatile uint8_t    buffer[RB_SIZE];
+    volatile RB_INDEX_T head;      // ISR producer
+    volatile RB_INDEX_T tail;      // main consumer
+    volatile uint32_t   overflow_count;
+    volatile bool       high_wm_flag;
+#ifdef RB_INSTRUMENT
+    volatile uint32_t   stat_peak_level;   // producer
+    volatile uint32_t   stat_wm_trips;     // producer
+    uint32_t            stat_lat_samples;  // consumer
+    uint32_t            stat_lat_hist[RING_BUFFER_LAT_BUCKETS];
+    uint32_t            stamp[RB_SIZE];    // RING_BUFFER_CYCLES() at push, per slot
+#endif
+} RB_T;
+
+// Core
+void       RB_FN(init)    (RB_T *rb);
+bool       RB_FN(is_empty)(const RB_T *rb);
+bool       RB_FN(is_full) (const RB_T *rb);
+RB_INDEX_T RB_FN(level)   (const RB_T *rb);
+bool       RB_FN(push)    (RB_T *rb, uint8_t data);     // ISR
+bool       RB_FN(pop)     (RB_T *rb, uint8_t *data);    // main
+void       RB_FN(get_status)(const RB_T *rb, ring_buffer_status_t *st);
+
+// Bulk
+uint32_t   RB_FN(push_n)  (RB_T *rb, const uint8_t *src, uint32_t len); // ISR, returns bytes stored
+uint32_t   RB_FN(pop_n)   (RB_T *rb, uint8_t *dst, uint32_t len);       // main, returns bytes read
+
+// Zero-copy read: peek fills span[0..1] and returns the total readable bytes;
+// the spans stay valid until commit releases them back to the producer.
+// With RB_OVERWRITE_OLDEST an overflow in between may overwrite them.
+uint32_t   RB_FN(peek)    (const RB_T *rb, ring_buffer_span_t span[2]); // main
+void       RB_FN(commit)  (RB_T *rb, uint32_t n);                       // main
+
+// Zero-copy write: reserve fills span[0..1] with the free space and returns
+// its size; store into it (readv, a driver copy), then publish what was
+// written. Nothing is claimed until publish, so n <= the reserved size.
+uint32_t   RB_FN(reserve) (const RB_T *rb, ring_buffer_wspan_t span[2]); // ISR
+
+// Publish n bytes a producer already stored at head (e.g. a circular DMA
+// writing straight into buffer[]). Storage was already written, so bytes past
+// the free space have overwritten the oldest ones whatever the policy: tail
+// moves past them and they are counted as overflow. Returns bytes published.
+uint32_t   RB_FN(publish) (RB_T *rb, uint32_t n);                       // ISR
+
+// Instrumentation snapshot; with reset the counters restart from now (peak
+// from the current level). Call from the consumer side: a producer update
+// racing with the reset can be lost. Zeroes *out without RB_INSTRUMENT.
+void       RB_FN(stats)   (RB_T *rb, ring_buffer_stats_t *out, bool reset);
+
+#else // RB_DEFINE
+
+// catch a .c whose parameters drifted from the header's
+_Static_assert(sizeof(((RB_T *)0)->buffer) == RB_SIZE, "RB_SIZE differs from declaration");
+_Static_assert(sizeof(((RB_T *)0)->head) == sizeof(RB_INDEX_T), "RB_INDEX_T differs from declaration");
+
+void RB_FN(init)(RB_T *rb) {
+    rb->head = 0;
+    rb->tail = 0;
+    rb->overflow_count = 0;
+    rb->high_wm_flag = false;
+#ifdef RB_INSTRUMENT
+    rb->stat_peak_level = 0;
+    rb->stat_wm_trips = 0;
+    rb->stat_lat_samples = 0;
+    memset(rb->stat_lat_hist, 0, sizeof rb->stat_lat_hist);
+#endif
+}
+
+bool RB_FN(is_empty)(const RB_T *rb) {
+    return rb->head == rb->tail;
+}
+
+bool RB_FN(is_full)(const RB_T *rb) {
+    return (RB_INDEX_T)((rb->head + 1u) & RB_MASK) == rb->tail;
+}
+
+RB_INDEX_T RB_FN(level)(const RB_T *rb) {
+    RB_INDEX_T h = rb->head;  // single-word snapshots (atomic when RB_INDEX_T is native width)
+    RB_INDEX_T t = rb->tail;
+    return (RB_INDEX_T)((h - t) & RB_MASK);
+}
+
+// Producer side, after head moved: watermark set (upward cross) + stats.
+static inline void RB_FN(on_fill_)(RB_T *rb) {
+    RB_INDEX_T level = RB_FN(level)(rb);
+    if (!rb->high_wm_flag && level >= RB_HIGH_WATERMARK) {
+        rb->high_wm_flag = true;
+#ifdef RB_INSTRUMENT
+        rb->stat_wm_trips++;
+#endif
+        // optional: callback/flow control here
+    }
+#ifdef RB_INSTRUMENT
+    if (level > rb->stat_peak_level) rb->stat_peak_level = level;
+#endif
+}
+
+#ifdef RB_INSTRUMENT
+static inline void RB_FN(stamp_)(RB_T *rb, RB_INDEX_T from, uint32_t n) {
+    uint32_t now = RING_BUFFER_CYCLES();
+    for (uint32_t i = 0; i < n; ++i) rb->stamp[(from + i) & RB_MASK] = now;
+}
+
+static inline void RB_FN(record_latency_)(RB_T *rb, RB_INDEX_T from, uint32_t n) {
+    uint32_t now = RING_BUFFER_CYCLES();
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t d = now - rb->stamp[(from + i) & RB_MASK];
+        uint32_t bucket = d ? 32u - (uint32_t)__builtin_clz(d) : 0u;
+        if (bucket >= RING_BUFFER_LAT_BUCKETS) bucket = RING_BUFFER_LAT_BUCKETS - 1u;
+        rb->stat_lat_hist[bucket]++;
+    }
+    rb->stat_lat_samples += n;
+}
+#endif
+
+bool RB_FN(push)(RB_T *rb, uint8_t data) {
+    RB_INDEX_T next_head = (RB_INDEX_T)((rb->head + 1u) & RB_MASK);
+
+    if (next_head == rb->tail) {
+        rb->overflow_count++;
+#ifdef RB_OVERWRITE_OLDEST
+        rb->buffer[rb->head] = data;
+#ifdef RB_INSTRUMENT
+        RB_FN(stamp_)(rb, rb->head, 1);
+#endif
+        rb->head = next_head;
+        rb->tail = (RB_INDEX_T)((rb->tail + 1u) & RB_MASK);
+        // level unchanged, flags unaffected
+        return true;
+#else
+        return false; // drop newest
+#endif
+    }
+
+    rb->buffer[rb->head] = data;
+#ifdef RB_INSTRUMENT
+    RB_FN(stamp_)(rb, rb->head, 1);
+#endif
+    rb->head = next_head;
+
+    RB_FN(on_fill_)(rb);
+    return true;
+}
+
+bool RB_FN(pop)(RB_T *rb, uint8_t *data) {
+    if (RB_FN(is_empty)(rb)) return false;
+
+    *data = rb->buffer[rb->tail];
+#ifdef RB_INSTRUMENT
+    RB_FN(record_latency_)(rb, rb->tail, 1);
+#endif
+    rb->tail = (RB_INDEX_T)((rb->tail + 1u) & RB_MASK);
+
+    // watermark clear (downward cross)
+    RB_INDEX_T level = RB_FN(level)(rb);
+    if (rb->high_wm_flag && level <= RB_LOW_WATERMARK) {
+        rb->high_wm_flag = false;
+        // optional: callback/flow control release here
+    }
+    return true;
+}
+
+void RB_FN(get_status)(const RB_T *rb, ring_buffer_status_t *st) {
+    st->level = RB_FN(level)(rb);
+    st->overflow_count = rb->overflow_count;
+    st->high_wm_active = rb->high_wm_flag;
+    st->utilization_percent = (uint8_t)(((uint64_t)st->level * 100u) / RB_SIZE);
+}
+
+// Bulk paths copy with memcpy instead of volatile byte stores, so the index
+// update needs a compiler fence to stay ordered after the data. A signal
+// fence is enough here: producer and consumer share one core (ISR vs main).
+
+uint32_t RB_FN(push_n)(RB_T *rb, const uint8_t *src, uint32_t len) {
+    RB_INDEX_T head = rb->head;
+    uint32_t free_slots = RB_MASK - (uint32_t)((RB_INDEX_T)(head - rb->tail) & RB_MASK);
+    uint32_t n = len;
+
+    if (n > free_slots) {
+        rb->overflow_count += len - free_slots;
+#ifdef RB_OVERWRITE_OLDEST
+        // only the newest RB_MASK bytes can survive; skip the rest
+        if (n > RB_MASK) {
+            src += n - RB_MASK;
+            n = RB_MASK;
+        }
+        rb->tail = (RB_INDEX_T)((rb->tail + (n - free_slots)) & RB_MASK);
+#else
+        n = free_slots; // drop newest
+#endif
+    }
+
+    uint32_t first = RB_SIZE - (uint32_t)head;
+    if (first > n) first = n;
+    memcpy((uint8_t *)&rb->buffer[head], src, first);
+    memcpy((uint8_t *)&rb->buffer[0], src + first, n - first);
+#ifdef RB_INSTRUMENT
+    RB_FN(stamp_)(rb, head, n);
+#endif
+    atomic_signal_fence(memory_order_release);
+    rb->head = (RB_INDEX_T)((head + n) & RB_MASK);
+
+    RB_FN(on_fill_)(rb);
+    return n;
+}
+
+uint32_t RB_FN(peek)(const RB_T *rb, ring_buffer_span_t span[2]) {
+    RB_INDEX_T h = rb->head;
+    RB_INDEX_T t = rb->tail;
+    atomic_signal_fence(memory_order_acquire);
+
+    const uint8_t *buf = (const uint8_t *)rb->buffer;
+    if (h >= t) {
+        span[0].data = buf + t;
+        span[0].len  = (uint32_t)(h - t);
+        span[1].data = buf;
+        span[1].len  = 0;
+    } else {
+        span[0].data = buf + t;
+        span[0].len  = RB_SIZE - (uint32_t)t;
+        span[1].data = buf;
+        span[1].len  = h;
+    }
+    return span[0].len + span[1].len;
+}
+
+void RB_FN(commit)(RB_T *rb, uint32_t n) {
+    RB_INDEX_T level = RB_FN(level)(rb);
+    if (n > level) n = level;
+
+#ifdef RB_INSTRUMENT
+    RB_FN(record_latency_)(rb, rb->tail, n);
+#endif
+    atomic_signal_fence(memory_order_release);
+    rb->tail = (RB_INDEX_T)((rb->tail + n) & RB_MASK);
+
+    // watermark clear (downward cross)
+    if (rb->high_wm_flag && RB_FN(level)(rb) <= RB_LOW_WATERMARK) {
+        rb->high_wm_flag = false;
+    }
+}
+
+uint32_t RB_FN(reserve)(const RB_T *rb, ring_buffer_wspan_t span[2]) {
+    RB_INDEX_T h = rb->head;
+    uint32_t free_slots = RB_MASK - (uint32_t)((RB_INDEX_T)(h - rb->tail) & RB_MASK);
+
+    // free space runs from head up to one short of tail, wrapping once
+    uint8_t *buf = (uint8_t *)rb->buffer;
+    uint32_t first = RB_SIZE - (uint32_t)h;
+    if (first > free_slots) first = free_slots;
+    span[0].data = buf + h;
+    span[0].len  = first;
+    span[1].data = buf;
+    span[1].len  = free_slots - first;
+    return free_slots;
+}
+
+uint32_t RB_FN(publish)(RB_T *rb, uint32_t n) {
+    RB_INDEX_T head = rb->head;
+    uint32_t free_slots = RB_MASK - (uint32_t)((RB_INDEX_T)(head - rb->tail) & RB_MASK);
+
+    if (n > free_slots) {
+        rb->overflow_count += n - free_slots;
+        if (n > RB_MASK) n = RB_MASK;  // a full lap: only the newest RB_MASK remain
+        rb->tail = (RB_INDEX_T)((head + n + 1u) & RB_MASK);
+    }
+
+#ifdef RB_INSTRUMENT
+    RB_FN(stamp_)(rb, head, n);   // time of the DMA event, not of each byte
+#endif
+    atomic_signal_fence(memory_order_release);
+    rb->head = (RB_INDEX_T)((head + n) & RB_MASK);
+
+    RB_FN(on_fill_)(rb);
+    return n;
+}
+
+uint32_t RB_FN(pop_n)(RB_T *rb, uint8_t *dst, uint32_t len) {
+    ring_buffer_span_t span[2];
+    uint32_t avail = RB_FN(peek)(rb, span);
+    if (len > avail) len = avail;
+
+    uint32_t first = span[0].len < len ? span[0].len : len;
+    memcpy(dst, span[0].data, first);
+    memcpy(dst + first, span[1].data, len - first);
+    RB_FN(commit)(rb, len);
+    return len;
+}
+
+void RB_FN(stats)(RB_T *rb, ring_buffer_stats_t *out, bool reset) {
+#ifdef RB_INSTRUMENT
+    out->peak_level  = rb->stat_peak_level;
+    out->wm_trips    = rb->stat_wm_trips;
+    out->lat_samples = rb->stat_lat_samples;
+    memcpy(out->lat_hist, rb->stat_lat_hist, sizeof out->lat_hist);
+    if (reset) {
+        rb->stat_peak_level = RB_FN(level)(rb);
+        rb->stat_wm_trips = 0;
+        rb->stat_lat_samples = 0;
+        memset(rb->stat_lat_hist, 0, sizeof rb->stat_lat_hist);
+    }
+#else
+    (void)rb;
+    (void)reset;
+    memset(out, 0, sizeof *out);
+#endif
+}
+
+#endif // RB_DEFINE
+
+#undef RB_T
+#undef RB_FN
+#undef RB_MASK
+#undef RB_NAME
+#undef RB_SIZE
+#undef RB_INDEX_T
+#undef RB_HIGH_WATERMARK
+#undef RB_LOW_WATERMARK
+#undef RB_OVERWRITE_OLDEST
+#undef RB_INSTRUMENT
+#undef RB_DEFINE
@@ -0,0 +1,84 @@
+// sim_wakeup.c - host comparison of the polling superloop against the
+// event-driven consumer (uart_rx_wait) on idle, trickle and burst traffic.
+//
+// Both run the echo task for one second of virtual time (uart_sim.h). The
+// superloop never sleeps: each pass costs loop_us of CPU whether or not data
+// arrived. The event loop sleeps in uart_rx_wait and pays wake_us per
+// wakeup. Reports CPU busy time, wakeups per second and the end-to-end echo
+// latency (RX byte in -> its echo fully shifted out).
+//
+// usage: sim_wakeup [wake_level] [timeout_us] [loop_us] [wake_us]
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "uart_hal.h"
+#include "uart_sim.h"
+
+#define RUN_NS  1000000000ull
+#define BAUD    115200u
+
+typedef struct {
+    const char *name;
+    uint32_t    burst;
+    uint64_t    gap_ns;
+    uint64_t    total;
+} traffic_t;
+
+static uint64_t loop_ns, wake_ns;
+
+static void run(const char *mode, bool event, const traffic_t *tr) {
+    uart_sim_reset();
+    uart_sim_set_baud(BAUD);
+    uart_init();
+    uart_sim_set_traffic(tr->burst, tr->gap_ns, tr->total);
+
+    uint64_t busy = 0;
+    while (uart_sim_now_ns() < RUN_NS) {
+        if (event) {
+            uint64_t woke = uart_sim_stats.wakeups;
+            uint32_t left_us = (uint32_t)((RUN_NS - uart_sim_now_ns() + 999u) / 1000u);
+            uart_rx_wait(left_us);
+            uint64_t cost = (uart_sim_stats.wakeups - woke) * wake_ns;
+            uart_sim_advance(cost);
+            busy += cost;
+        } else {
+            uart_sim_advance(loop_ns);
+            busy += loop_ns;
+        }
+        uart_echo_task();
+        uart_monitor_task();
+    }
+
+    const uart_sim_stats_t *s = &uart_sim_stats;
+    double secs = uart_sim_now_ns() / 1e9;
+    printf("%-8s %-8s %8.2f%% %10.0f %8llu %10.3f %10.3f\n", tr->name, mode,
+           100.0 * (double)busy / (double)uart_sim_now_ns(), s->wakeups / secs,
+           (unsigned long long)s->echo_bytes,
+           s->echo_bytes ? s->echo_lat_sum_ns / 1e6 / s->echo_bytes : 0.0,
+           s->echo_lat_max_ns / 1e6);
+}
+
+int main(int argc, char **argv) {
+    uint32_t level   = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : UART_RX_WAKE_LEVEL;
+    uint32_t timeout = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : UART_RX_WAKE_TIMEOUT_US;
+    loop_ns = (argc > 3 ? strtoull(argv[3], NULL, 0) : 5u) * 1000u;
+    wake_ns = (argc > 4 ? strtoull(argv[4], NULL, 0) : 5u) * 1000u;
+
+    static const traffic_t traffic[] = {
+        { "idle",    1,  0,            0 },
+        { "trickle", 1,  20000000ull,  50 },     // 1 B every 20 ms
+        { "burst",   48, 100000000ull, 480 },    // 48 B every 100 ms
+    };
+
+    uart_rx_set_wakeup(level, timeout);
+    printf("%u baud, 1 s each, wake level %u B, timeout %u us, loop %llu us, wake %llu us\n",
+           BAUD, level, timeout, (unsigned long long)(loop_ns / 1000u),
+           (unsigned long long)(wake_ns / 1000u));
+    printf("%-8s %-8s %9s %10s %8s %10s %10s\n",
+           "traffic", "loop", "cpu", "wakeups/s", "echoed", "mean ms", "max ms");
+    for (size_t i = 0; i < sizeof traffic / sizeof traffic[0]; ++i) {
+        run("poll",  false, &traffic[i]);
+        run("event", true,  &traffic[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,638 @@
+// tests.c - host tests for the ring buffers (assert-based, like the
+// circular buffer project). Build: see README.
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "ringbuf.h"
+#include "ringbuf_spsc.h"
+#include "ringbuf_mpsc.h"
+#include "frame_codec.h"
+
+#define ASSERT_TRUE(x)  assert((x))
+#define ASSERT_EQ(a,b)  assert((a) == (b))
+#define ASSERT_MEMEQ(a,b,n) assert(memcmp((a),(b),(n))==0)
+
+#define STRESS_BYTES (8u * 1000u * 1000u)
+#define MPSC_PRODUCERS 4u
+#define MPSC_RECORDS   (500u * 1000u)   // per producer
+
+// Independently sized instances, as a firmware image with a high-rate port
+// and a console would declare them (header side, then RB_DEFINE side).
+#define RB_NAME    hs_rx
+#define RB_SIZE    4096
+#define RB_INDEX_T uint16_t
+#define RB_OVERWRITE_OLDEST
+#include "ringbuf_template.h"
+#define RB_NAME    hs_rx
+#define RB_SIZE    4096
+#define RB_INDEX_T uint16_t
+#define RB_OVERWRITE_OLDEST
+#define RB_DEFINE
+#include "ringbuf_template.h"
+
+#define RB_NAME    console_rx
+#define RB_SIZE    64
+#define RB_INDEX_T uint8_t
+#include "ringbuf_template.h"
+#define RB_NAME    console_rx
+#define RB_SIZE    64
+#define RB_INDEX_T uint8_t
+#define RB_DEFINE
+#include "ringbuf_template.h"
+
+#define RB_NAME    bulk_rx
+#define RB_SIZE    (128u * 1024u)
+#define RB_INDEX_T uint32_t
+#include "ringbuf_template.h"
+#define RB_NAME    bulk_rx
+#define RB_SIZE    (128u * 1024u)
+#define RB_INDEX_T uint32_t
+#define RB_DEFINE
+#include "ringbuf_template.h"
+
+#define RB_NAME    inst_rx
+#define RB_SIZE    64
+#define RB_INDEX_T uint8_t
+#define RB_INSTRUMENT
+#include "ringbuf_template.h"
+#define RB_NAME    inst_rx
+#define RB_SIZE    64
+#define RB_INDEX_T uint8_t
+#define RB_INSTRUMENT
+#define RB_DEFINE
+#include "ringbuf_template.h"
+
+static ring_buffer_t      rb;
+static inst_rx_t          inst;
+static hs_rx_t            hs;
+static console_rx_t       con;
+static bulk_rx_t          big;
+static ring_buffer_spsc_t spsc;
+static ring_buffer_mpsc_t mpsc;
+
+static void test_bulk_wrap_and_spans(void) {
+    ring_buffer_init(&rb);
+    uint8_t in[RING_BUFFER_SIZE], out[RING_BUFFER_SIZE];
+    for (uint32_t i = 0; i < RING_BUFFER_SIZE; ++i) in[i] = (uint8_t)(i + 1u);
+
+    // move head/tail near the end so the next write wraps
+    ASSERT_EQ(ring_buffer_push_n(&rb, in, RING_BUFFER_SIZE - 5u), RING_BUFFER_SIZE - 5u);
+    ASSERT_EQ(ring_buffer_pop_n(&rb, out, RING_BUFFER_SIZE), RING_BUFFER_SIZE - 5u);
+    ASSERT_MEMEQ(out, in, RING_BUFFER_SIZE - 5u);
+
+    ASSERT_EQ(ring_buffer_push_n(&rb, in, 20), 20u);
+    ring_buffer_span_t span[2];
+    ASSERT_EQ(ring_buffer_peek(&rb, span), 20u);
+    ASSERT_EQ(span[0].len, 5u);
+    ASSERT_EQ(span[1].len, 15u);
+    ASSERT_MEMEQ(span[0].data, in, 5);
+    ASSERT_MEMEQ(span[1].data, in + 5, 15);
+
+    ring_buffer_commit(&rb, 7);
+    uint8_t b;
+    ASSERT_TRUE(ring_buffer_pop(&rb, &b));
+    ASSERT_EQ(b, in[7]);
+    ASSERT_EQ(ring_buffer_pop_n(&rb, out, sizeof out), 12u);
+    ASSERT_MEMEQ(out, in + 8, 12);
+    ASSERT_TRUE(ring_buffer_is_empty(&rb));
+}
+
+static void test_bulk_overflow_accounting(void) {
+    ring_buffer_init(&rb);
+    uint8_t in[RING_BUFFER_SIZE + 10], out[RING_BUFFER_SIZE];
+    for (uint32_t i = 0; i < sizeof in; ++i) in[i] = (uint8_t)i;
+
+    ring_buffer_status_t st;
+    uint32_t n = ring_buffer_push_n(&rb, in, sizeof in);
+    ring_buffer_get_status(&rb, &st);
+    ASSERT_EQ(st.overflow_count, sizeof in - (RING_BUFFER_SIZE - 1u));
+    ASSERT_EQ(ring_buffer_pop_n(&rb, out, sizeof out), RING_BUFFER_SIZE - 1u);
+#ifdef OVERWRITE_OLDEST
+    ASSERT_EQ(n, RING_BUFFER_SIZE - 1u);    // newest bytes kept
+    ASSERT_MEMEQ(out, in + sizeof in - n, n);
+#else
+    ASSERT_EQ(n, RING_BUFFER_SIZE - 1u);    // oldest bytes kept
+    ASSERT_MEMEQ(out, in, n);
+#endif
+}
+
+static void test_bulk_watermark_hysteresis(void) {
+    ring_buffer_init(&rb);
+    uint8_t in[RING_BUFFER_SIZE] = {0};
+    ring_buffer_status_t st;
+    ring_buffer_span_t span[2];
+
+    ring_buffer_push_n(&rb, in, HIGH_WATERMARK - 1u);
+    ring_buffer_get_status(&rb, &st);
+    ASSERT_TRUE(!st.high_wm_active);
+
+    ring_buffer_push_n(&rb, in, 1);
+    ring_buffer_get_status(&rb, &st);
+    ASSERT_TRUE(st.high_wm_active);
+
+    // a commit that stays above LOW_WATERMARK keeps the flag
+    ring_buffer_peek(&rb, span);
+    ring_buffer_commit(&rb, HIGH_WATERMARK - LOW_WATERMARK - 1u);
+    ring_buffer_get_status(&rb, &st);
+    ASSERT_TRUE(st.high_wm_active);
+
+    // one big commit straight past LOW_WATERMARK clears it
+    ring_buffer_peek(&rb, span);
+    ring_buffer_commit(&rb, LOW_WATERMARK + 1u);
+    ring_buffer_get_status(&rb, &st);
+    ASSERT_TRUE(!st.high_wm_active);
+    ASSERT_EQ(st.level, 0);
+}
+
+// A DMA-style producer writes buffer[] itself and only publishes counts.
+// Counts follow RING_BUFFER_SIZE (40/30/58 at 64).
+static void test_publish_dma_style(void) {
+    enum { FIRST = RING_BUFFER_SIZE * 5 / 8, UNREAD = 10, SECOND = RING_BUFFER_SIZE - 6 };
+    enum { LAPPED = UNREAD + SECOND - (RING_BUFFER_SIZE - 1) };   // 5
+    ring_buffer_init(&rb);
+    uint8_t out[RING_BUFFER_SIZE];
+    uint32_t pos = 0;
+
+    for (uint32_t i = 0; i < FIRST; ++i) rb.buffer[(pos + i) & RING_BUFFER_MASK] = (uint8_t)i;
+    ASSERT_EQ(ring_buffer_publish(&rb, FIRST), (uint32_t)FIRST);
+    pos += FIRST;
+    ASSERT_EQ(ring_buffer_pop_n(&rb, out, FIRST - UNREAD), (uint32_t)(FIRST - UNREAD));
+
+    // wraps, and laps the unread bytes by LAPPED: the newest SIZE - 1 remain
+    for (uint32_t i = 0; i < SECOND; ++i) rb.buffer[(pos + i) & RING_BUFFER_MASK] = (uint8_t)(100 + i);
+    ring_buffer_publish(&rb, SECOND);
+    ring_buffer_status_t st;
+    ring_buffer_get_status(&rb, &st);
+    ASSERT_EQ(st.level, RING_BUFFER_SIZE - 1u);
+    ASSERT_EQ(st.overflow_count, (uint32_t)LAPPED);
+    ASSERT_TRUE(st.high_wm_active);
+
+    ASSERT_EQ(ring_buffer_pop_n(&rb, out, sizeof out), RING_BUFFER_SIZE - 1u);
+    for (uint32_t i = 0; i < UNREAD - LAPPED; ++i) {
+        ASSERT_EQ(out[i], (uint8_t)(FIRST - UNREAD + LAPPED + i));
+    }
+    for (uint32_t i = 0; i < SECOND; ++i) {
+        ASSERT_EQ(out[UNREAD - LAPPED + i], (uint8_t)(100 + i));
+    }
+}
+
+// Producer-side spans (readv-style): fill the free space in place, publish.
+static void test_reserve_publish(void) {
+    ring_buffer_init(&rb);
+    uint8_t in[RING_BUFFER_SIZE], out[RING_BUFFER_SIZE];
+    for (uint32_t i = 0; i < RING_BUFFER_SIZE; ++i) in[i] = (uint8_t)(i ^ 0x5Au);
+
+    ring_buffer_push_n(&rb, in, RING_BUFFER_SIZE - 10u);
+    ring_buffer_pop_n(&rb, out, RING_BUFFER_SIZE - 20u);     // head 54, tail 44
+
+    ring_buffer_wspan_t span[2];
+    ASSERT_EQ(ring_buffer_reserve(&rb, span), RING_BUFFER_SIZE - 11u);
+    ASSERT_EQ(span[0].len, 10u);                             // up to the end
+    ASSERT_EQ(span[1].len, RING_BUFFER_SIZE - 21u);          // one short of tail
+    memcpy(span[0].data, in, span[0].len);
+    memcpy(span[1].data, in + span[0].len, 5);
+    ASSERT_EQ(ring_buffer_publish(&rb, 15), 15u);
+
+    ASSERT_EQ(ring_buffer_pop_n(&rb, out, sizeof out), 25u);
+    ASSERT_MEMEQ(out + 10, in, 15);
+    ASSERT_EQ(rb.overflow_count, 0u);
+
+    // full ring: nothing to reserve
+    ring_buffer_push_n(&rb, in, RING_BUFFER_SIZE);
+    ASSERT_EQ(ring_buffer_reserve(&rb, span), 0u);
+    ASSERT_EQ(span[0].len + span[1].len, 0u);
+}
+
+static void test_sized_instances(void) {
+    static uint8_t in[128u * 1024u], out[128u * 1024u];
+    for (uint32_t i = 0; i < sizeof in; ++i) in[i] = (uint8_t)(i ^ (i >> 9));
+    ring_buffer_status_t st;
+
+    ASSERT_EQ(sizeof(con.head), 1u);
+    ASSERT_EQ(sizeof(hs.head), 2u);
+    ASSERT_EQ(sizeof(big.head), 4u);
+
+    // console: 64 bytes, drop newest
+    console_rx_init(&con);
+    ASSERT_EQ(console_rx_push_n(&con, in, 100), 63u);
+    console_rx_get_status(&con, &st);
+    ASSERT_EQ(st.level, 63u);
+    ASSERT_EQ(st.overflow_count, 37u);
+
+    // high-rate port: 4 KiB, overwrite oldest, well past the old 256-byte ceiling
+    hs_rx_init(&hs);
+    for (uint32_t off = 0; off < 5000u; off += 1000u) hs_rx_push_n(&hs, in + off, 1000u);
+    hs_rx_get_status(&hs, &st);
+    ASSERT_EQ(st.level, 4095u);
+    ASSERT_EQ(st.overflow_count, 5000u - 4095u);
+    ASSERT_TRUE(st.high_wm_active);
+    ASSERT_EQ(hs_rx_pop_n(&hs, out, sizeof out), 4095u);
+    ASSERT_MEMEQ(out, in + 5000u - 4095u, 4095u);
+
+    // 128 KiB with 32-bit indices, wrapping
+    bulk_rx_init(&big);
+    ASSERT_EQ(bulk_rx_push_n(&big, in, 100000u), 100000u);
+    ASSERT_EQ(bulk_rx_pop_n(&big, out, 90000u), 90000u);
+    ASSERT_EQ(bulk_rx_push_n(&big, in, sizeof in), 128u * 1024u - 1u - 10000u);
+    ring_buffer_span_t span[2];
+    ASSERT_EQ(bulk_rx_peek(&big, span), 128u * 1024u - 1u);
+    ASSERT_MEMEQ(span[0].data, in + 90000u, 10000u);
+    ASSERT_MEMEQ(span[0].data + 10000u, in, span[0].len - 10000u);
+    ASSERT_MEMEQ(span[1].data, in + span[0].len - 10000u, span[1].len);
+}
+
+static void test_instrumentation(void) {
+    uint8_t in[64] = {0}, out[64];
+    ring_buffer_stats_t s;
+    inst_rx_init(&inst);
+
+    // two trips: fill past 48, drain below 16, fill again
+    inst_rx_push_n(&inst, in, 50);
+    ASSERT_EQ(inst_rx_pop_n(&inst, out, 40), 40u);
+    inst_rx_push_n(&inst, in, 45);
+    uint8_t b;
+    ASSERT_TRUE(inst_rx_pop(&inst, &b));
+
+    inst_rx_stats(&inst, &s, true);
+    ASSERT_EQ(s.peak_level, 55u);
+    ASSERT_EQ(s.wm_trips, 2u);
+    ASSERT_EQ(s.lat_samples, 41u);
+    uint32_t sum = 0;
+    for (uint32_t k = 0; k < RING_BUFFER_LAT_BUCKETS; ++k) sum += s.lat_hist[k];
+    ASSERT_EQ(sum, 41u);
+
+    // reset-on-read: peak restarts from the current level, counters from 0
+    inst_rx_stats(&inst, &s, false);
+    ASSERT_EQ(s.peak_level, 54u);
+    ASSERT_EQ(s.wm_trips, 0u);
+    ASSERT_EQ(s.lat_samples, 0u);
+
+    // uninstrumented instances report zeros
+    ring_buffer_init(&rb);
+    ring_buffer_push_n(&rb, in, 60);
+#ifndef RING_BUFFER_INSTRUMENT
+    ring_buffer_stats(&rb, &s, true);
+    ASSERT_EQ(s.peak_level, 0u);
+    ASSERT_EQ(s.wm_trips, 0u);
+#endif
+}
+
+typedef struct {
+    uint32_t count;
+    uint32_t len[64];
+    uint8_t  data[64][32];
+} frame_log_t;
+
+static void log_frame(void *ctx, const uint8_t *payload, uint32_t len) {
+    frame_log_t *log = ctx;
+    ASSERT_TRUE(log->count < 64u && len <= 32u);
+    memcpy(log->data[log->count], payload, len);
+    log->len[log->count++] = len;
+}
+
+// Payload k: k+1 bytes that hit every delimiter/escape value.
+static uint32_t frame_payload(uint32_t k, uint8_t *p) {
+    static const uint8_t special[] = { 0x00, 0xC0, 0xDB, 0xDC, 0xDD, 0xFF };
+    for (uint32_t i = 0; i <= k % 20u; ++i) p[i] = special[(k + i) % sizeof special] ^ (uint8_t)(i & 0x20u);
+    return k % 20u + 1u;
+}
+
+static void test_frames_wrap_and_partial(void) {
+    static const frame_codec_t codecs[] = { FRAME_SLIP, FRAME_COBS };
+    for (uint32_t c = 0; c < 2; ++c) {
+        uint8_t wire[64 * 48], p[32];
+        uint32_t wlen = 0;
+        for (uint32_t k = 0; k < 64; ++k) {
+            uint32_t n = frame_payload(k, p);
+            uint32_t e = frame_encode(codecs[c], p, n, wire + wlen, sizeof wire - wlen);
+            ASSERT_TRUE(e > n + 2u);
+            wlen += e;
+        }
+
+        // odd chunk sizes: frames end mid-chunk and straddle the wrap
+        static frame_log_t log;
+        frame_decoder_t fd;
+        memset(&log, 0, sizeof log);
+        frame_decoder_init(&fd, codecs[c], log_frame, &log);
+        ring_buffer_init(&rb);
+        for (uint32_t off = 0, step = 1; off < wlen; off += step, step = step % 13u + 1u) {
+            if (step > wlen - off) step = wlen - off;
+            ASSERT_EQ(ring_buffer_push_n(&rb, wire + off, step), step);
+            frame_decoder_poll(&fd, &rb);
+        }
+        ASSERT_TRUE(ring_buffer_is_empty(&rb));
+        ASSERT_EQ(fd.stats.frames, 64u);
+        ASSERT_EQ(fd.stats.crc_errors + fd.stats.decode_errors + fd.stats.oversize, 0u);
+        for (uint32_t k = 0; k < 64; ++k) {
+            uint32_t n = frame_payload(k, p);
+            ASSERT_EQ(log.len[k], n);
+            ASSERT_MEMEQ(log.data[k], p, n);
+        }
+    }
+}
+
+static void test_frames_errors_and_resync(void) {
+    static frame_log_t log;
+    frame_decoder_t fd;
+    uint8_t wire[48], p[] = { 1, 2, 3, 4 };
+    memset(&log, 0, sizeof log);
+    frame_decoder_init(&fd, FRAME_COBS, log_frame, &log);
+    ring_buffer_init(&rb);
+
+    // flipped payload bit -> CRC error, next frame still decodes
+    uint32_t e = frame_encode(FRAME_COBS, p, sizeof p, wire, sizeof wire);
+    wire[2] ^= 0x10u;
+    ring_buffer_push_n(&rb, wire, e);
+    wire[2] ^= 0x10u;
+    ring_buffer_push_n(&rb, wire, e);
+    ASSERT_EQ(frame_decoder_poll(&fd, &rb), 1u);
+    ASSERT_EQ(fd.stats.crc_errors, 1u);
+
+    // no delimiter until the ring fills: dropped, then resync on the next one
+    uint8_t junk[RING_BUFFER_SIZE];
+    memset(junk, 0x55, sizeof junk);
+    ring_buffer_push_n(&rb, junk, RING_BUFFER_SIZE - 1u);
+    ASSERT_EQ(frame_decoder_poll(&fd, &rb), 0u);
+    ASSERT_TRUE(ring_buffer_is_empty(&rb));
+    ASSERT_EQ(fd.stats.oversize, 1u);
+    junk[9] = 0x00;                                       // rest of the runaway frame
+    ring_buffer_push_n(&rb, junk, 10);
+    ring_buffer_push_n(&rb, wire, e);
+    ASSERT_EQ(frame_decoder_poll(&fd, &rb), 1u);
+    ASSERT_EQ(log.count, 2u);
+    ASSERT_MEMEQ(log.data[1], p, sizeof p);
+
+    // runt: shorter than the CRC
+    static const uint8_t runt[] = { 0x02, 0x11, 0x00 };
+    ring_buffer_push_n(&rb, runt, sizeof runt);
+    ASSERT_EQ(frame_decoder_poll(&fd, &rb), 0u);
+    ASSERT_EQ(fd.stats.decode_errors, 1u);
+}
+
+static void test_spsc_fill_and_drain(void) {
+    ring_buffer_spsc_init(&spsc);
+
+    // one slot is kept empty, same as ring_buffer_t
+    for (uint32_t i = 0; i < RING_BUFFER_SIZE - 1u; ++i) {
+        ASSERT_TRUE(ring_buffer_spsc_push(&spsc, (uint8_t)i));
+    }
+    ASSERT_TRUE(!ring_buffer_spsc_push(&spsc, 0xAA));   // drop newest
+    ASSERT_EQ(ring_buffer_spsc_level(&spsc), RING_BUFFER_SIZE - 1u);
+
+    ring_buffer_status_t st;
+    ring_buffer_spsc_get_status(&spsc, &st);
+    ASSERT_EQ(st.overflow_count, 1u);
+    ASSERT_TRUE(st.high_wm_active);
+
+    uint8_t b;
+    for (uint32_t i = 0; i < RING_BUFFER_SIZE - 1u; ++i) {
+        ASSERT_TRUE(ring_buffer_spsc_pop(&spsc, &b));
+        ASSERT_EQ(b, (uint8_t)i);
+    }
+    ASSERT_TRUE(!ring_buffer_spsc_pop(&spsc, &b));
+
+    ring_buffer_spsc_get_status(&spsc, &st);
+    ASSERT_EQ(st.level, 0);
+    ASSERT_TRUE(!st.high_wm_active);
+}
+
+static void *spsc_producer(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < STRESS_BYTES; ++i) {
+        while (!ring_buffer_spsc_push(&spsc, (uint8_t)(i * 7u + (i >> 8)))) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// Producer and consumer on separate threads: every byte must arrive exactly
+// once and in order. Run under -fsanitize=thread to check the ordering.
+static void test_spsc_threads_no_loss_no_reorder(void) {
+    ring_buffer_spsc_init(&spsc);
+
+    pthread_t prod;
+    ASSERT_EQ(pthread_create(&prod, NULL, spsc_producer, NULL), 0);
+
+    uint8_t b;
+    for (uint32_t i = 0; i < STRESS_BYTES; ++i) {
+        while (!ring_buffer_spsc_pop(&spsc, &b)) {
+            sched_yield();
+        }
+        ASSERT_EQ(b, (uint8_t)(i * 7u + (i >> 8)));
+    }
+
+    pthread_join(prod, NULL);
+    ASSERT_TRUE(!ring_buffer_spsc_pop(&spsc, &b));
+}
+
+// Nested-ISR pattern: B preempts A between reserve and commit. B is not
+// visible until A is committed, and the ranges do not interleave.
+static void test_mpsc_out_of_order_commit(void) {
+    ring_buffer_mpsc_init(&mpsc);
+    ring_buffer_mpsc_resv_t a, b, c;
+    uint8_t out[RING_BUFFER_SIZE];
+
+    ASSERT_TRUE(ring_buffer_mpsc_reserve(&mpsc, 3, &a));
+    ASSERT_TRUE(ring_buffer_mpsc_reserve(&mpsc, 2, &b));
+    memcpy(b.data[0], "BB", 2);
+    ring_buffer_mpsc_commit(&mpsc, &b);
+    ASSERT_EQ(ring_buffer_mpsc_pop_n(&mpsc, out, sizeof out), 0u);
+    memcpy(a.data[0], "AAA", 3);
+    ring_buffer_mpsc_commit(&mpsc, &a);
+    ASSERT_EQ(ring_buffer_mpsc_pop_n(&mpsc, out, sizeof out), 5u);
+    ASSERT_MEMEQ(out, "AAABB", 5);
+
+    // a range across the wrap comes back as two spans
+    uint8_t in[RING_BUFFER_SIZE];
+    for (uint32_t i = 0; i < RING_BUFFER_SIZE; ++i) in[i] = (uint8_t)(i * 3u);
+    ASSERT_TRUE(ring_buffer_mpsc_reserve(&mpsc, RING_BUFFER_SIZE - 2u, &a));
+    ASSERT_EQ(a.len[0], RING_BUFFER_SIZE - 5u);
+    ASSERT_EQ(a.len[1], 3u);
+    memcpy(a.data[0], in, a.len[0]);
+    memcpy(a.data[1], in + a.len[0], a.len[1]);
+    ring_buffer_mpsc_commit(&mpsc, &a);
+    ASSERT_EQ(ring_buffer_mpsc_pop_n(&mpsc, out, sizeof out), RING_BUFFER_SIZE - 2u);
+    ASSERT_MEMEQ(out, in, RING_BUFFER_SIZE - 2u);
+
+    // the committed prefix is published while later ranges stay open, so
+    // overlapping producers never hide it from the consumer
+    ASSERT_TRUE(ring_buffer_mpsc_reserve(&mpsc, 1, &a));
+    ASSERT_TRUE(ring_buffer_mpsc_reserve(&mpsc, 1, &b));
+    a.data[0][0] = 'a';
+    ring_buffer_mpsc_commit(&mpsc, &a);
+    ASSERT_TRUE(ring_buffer_mpsc_reserve(&mpsc, 1, &c));
+    ASSERT_EQ(ring_buffer_mpsc_pop_n(&mpsc, out, sizeof out), 1u);
+    ASSERT_EQ(out[0], 'a');
+    c.data[0][0] = 'c';
+    ring_buffer_mpsc_commit(&mpsc, &c);
+    ASSERT_EQ(ring_buffer_mpsc_pop_n(&mpsc, out, sizeof out), 0u);
+    b.data[0][0] = 'b';
+    ring_buffer_mpsc_commit(&mpsc, &b);
+    ASSERT_EQ(ring_buffer_mpsc_pop_n(&mpsc, out, sizeof out), 2u);
+    ASSERT_MEMEQ(out, "bc", 2);
+
+    // at most RING_BUFFER_MPSC_SLOTS open at once
+    ring_buffer_mpsc_resv_t held[RING_BUFFER_MPSC_SLOTS];
+    ring_buffer_status_t st;
+    ring_buffer_mpsc_get_status(&mpsc, &st);
+    for (uint32_t i = 0; i < RING_BUFFER_MPSC_SLOTS; ++i) {
+        ASSERT_TRUE(ring_buffer_mpsc_reserve(&mpsc, 1, &held[i]));
+        held[i].data[0][0] = (uint8_t)i;
+    }
+    ASSERT_TRUE(!ring_buffer_mpsc_reserve(&mpsc, 1, &a));
+    uint32_t dropped = st.overflow_count;
+    ring_buffer_mpsc_get_status(&mpsc, &st);
+    ASSERT_EQ(st.overflow_count, dropped + 1u);
+    for (uint32_t i = RING_BUFFER_MPSC_SLOTS; i-- > 0; ) ring_buffer_mpsc_commit(&mpsc, &held[i]);
+    ASSERT_EQ(ring_buffer_mpsc_pop_n(&mpsc, out, sizeof out), RING_BUFFER_MPSC_SLOTS);
+    for (uint32_t i = 0; i < RING_BUFFER_MPSC_SLOTS; ++i) ASSERT_EQ(out[i], (uint8_t)i);
+}
+
+static void test_mpsc_overflow_accounting(void) {
+    ring_buffer_mpsc_init(&mpsc);
+    uint8_t in[RING_BUFFER_SIZE], out[RING_BUFFER_SIZE];
+    for (uint32_t i = 0; i < RING_BUFFER_SIZE; ++i) in[i] = (uint8_t)i;
+    ring_buffer_status_t st;
+
+    // all RING_BUFFER_SIZE bytes are usable
+    ASSERT_TRUE(ring_buffer_mpsc_push_n(&mpsc, in, RING_BUFFER_SIZE - 8u));
+    ASSERT_TRUE(ring_buffer_mpsc_push_n(&mpsc, in, 8));
+#ifndef OVERWRITE_OLDEST
+    ASSERT_TRUE(!ring_buffer_mpsc_push_n(&mpsc, in, 4));        // drop newest
+    ring_buffer_mpsc_get_status(&mpsc, &st);
+    ASSERT_EQ(st.level, RING_BUFFER_SIZE);
+    ASSERT_EQ(st.overflow_count, 4u);
+    ASSERT_TRUE(st.high_wm_active);
+    ASSERT_EQ(ring_buffer_mpsc_pop_n(&mpsc, out, sizeof out), RING_BUFFER_SIZE);
+    ASSERT_MEMEQ(out + RING_BUFFER_SIZE - 8u, in, 8);
+#else
+    // the oldest 4 committed bytes make room; an open range is never evicted
+    ASSERT_TRUE(ring_buffer_mpsc_push_n(&mpsc, in, 4));
+    ring_buffer_mpsc_get_status(&mpsc, &st);
+    ASSERT_EQ(st.overflow_count, 4u);
+    ASSERT_EQ(ring_buffer_mpsc_pop_n(&mpsc, out, 4), 4u);
+    ASSERT_MEMEQ(out, in + 4, 4);
+    ring_buffer_mpsc_resv_t r;
+    ASSERT_TRUE(ring_buffer_mpsc_reserve(&mpsc, 4, &r));
+    ASSERT_TRUE(!ring_buffer_mpsc_push_n(&mpsc, in, RING_BUFFER_SIZE));
+    ring_buffer_mpsc_commit(&mpsc, &r);
+    ASSERT_EQ(ring_buffer_mpsc_pop_n(&mpsc, out, sizeof out), RING_BUFFER_SIZE);
+#endif
+    ring_buffer_mpsc_get_status(&mpsc, &st);
+    ASSERT_EQ(st.level, 0);
+    ASSERT_TRUE(!st.high_wm_active);
+}
+
+#ifndef OVERWRITE_OLDEST
+// Record = producer id + 32-bit sequence + filler, 8 bytes
+static void *mpsc_producer(void *arg) {
+    uint8_t id = (uint8_t)(uintptr_t)arg;
+    uint8_t rec[8] = { id, 0, 0, 0, 0, id, id, id };
+    for (uint32_t seq = 0; seq < MPSC_RECORDS; ++seq) {
+        memcpy(rec + 1, &seq, sizeof seq);
+        while (!ring_buffer_mpsc_push_n(&mpsc, rec, sizeof rec)) sched_yield();
+    }
+    return NULL;
+}
+
+// Several producers, one consumer: records arrive whole, and each
+// producer's sequence arrives complete and in order.
+static void test_mpsc_threads_records_intact(void) {
+    ring_buffer_mpsc_init(&mpsc);
+    pthread_t prod[MPSC_PRODUCERS];
+    uint32_t next[MPSC_PRODUCERS] = {0};
+
+    for (uint32_t p = 0; p < MPSC_PRODUCERS; ++p) {
+        ASSERT_EQ(pthread_create(&prod[p], NULL, mpsc_producer, (void *)(uintptr_t)p), 0);
+    }
+    for (uint32_t got = 0; got < MPSC_PRODUCERS * MPSC_RECORDS; ) {
+        uint8_t rec[8];
+        uint32_t n = ring_buffer_mpsc_pop_n(&mpsc, rec, sizeof rec);
+        if (n == 0) {
+            sched_yield();
+            continue;
+        }
+        ASSERT_EQ(n, sizeof rec);               // committed only at range ends
+        uint32_t id = rec[0], seq;
+        memcpy(&seq, rec + 1, sizeof seq);
+        ASSERT_TRUE(id < MPSC_PRODUCERS && rec[5] == id && rec[7] == id);
+        ASSERT_EQ(seq, next[id]);
+        next[id]++;
+        got++;
+    }
+    for (uint32_t p = 0; p < MPSC_PRODUCERS; ++p) pthread_join(prod[p], NULL);
+    ASSERT_EQ(ring_buffer_mpsc_level(&mpsc), 0u);
+}
+
+#else
+static _Atomic uint32_t mpsc_producers_done;
+
+static void *mpsc_overwriting_producer(void *arg) {
+    uint8_t id = (uint8_t)(uintptr_t)arg;
+    uint8_t rec[8];
+    for (uint32_t seq = 0; seq < MPSC_RECORDS; ++seq) {
+        memset(rec, (int)(id << 6 | (seq & 63u)), sizeof rec);
+        ring_buffer_mpsc_push_n(&mpsc, rec, sizeof rec);    // may evict or be dropped
+        if ((seq & 255u) == 0) sched_yield();             // let the consumer in
+    }
+    atomic_fetch_add(&mpsc_producers_done, 1u);
+    return NULL;
+}
+
+// Producers evict while the consumer copies out. Run under TSan: the
+// consumer's copy and the producers' writes never touch the same bytes.
+// Every byte pushed is either read or counted as overflow, exactly once.
+static void test_mpsc_threads_overwrite_accounting(void) {
+    ring_buffer_mpsc_init(&mpsc);
+    atomic_store(&mpsc_producers_done, 0u);
+    pthread_t prod[MPSC_PRODUCERS];
+    uint64_t got = 0;
+
+    for (uint32_t p = 0; p < MPSC_PRODUCERS; ++p) {
+        ASSERT_EQ(pthread_create(&prod[p], NULL, mpsc_overwriting_producer, (void *)(uintptr_t)p), 0);
+    }
+    for (;;) {
+        bool finished = atomic_load(&mpsc_producers_done) == MPSC_PRODUCERS;
+        uint8_t buf[RING_BUFFER_SIZE];
+        uint32_t n = ring_buffer_mpsc_pop_n(&mpsc, buf, sizeof buf);
+        got += n;
+        if (n == 0) {
+            if (finished) break;
+            sched_yield();
+        }
+    }
+    for (uint32_t p = 0; p < MPSC_PRODUCERS; ++p) pthread_join(prod[p], NULL);
+
+    ring_buffer_status_t st;
+    ring_buffer_mpsc_get_status(&mpsc, &st);
+    ASSERT_EQ(st.level, 0);
+    ASSERT_EQ(got + st.overflow_count, (uint64_t)MPSC_PRODUCERS * MPSC_RECORDS * 8u);
+}
+#endif
+
+int main(void) {
+    test_bulk_wrap_and_spans();
+    test_bulk_overflow_accounting();
+    test_bulk_watermark_hysteresis();
+    test_publish_dma_style();
+    test_reserve_publish();
+    test_sized_instances();
+    test_instrumentation();
+    test_frames_wrap_and_partial();
+    test_frames_errors_and_resync();
+    test_spsc_fill_and_drain();
+    test_spsc_threads_no_loss_no_reorder();
+    test_mpsc_out_of_order_commit();
+    test_mpsc_overflow_accounting();
+#ifndef OVERWRITE_OLDEST
+    test_mpsc_threads_records_intact();     // overwrite mode would drop records
+#else
+    test_mpsc_threads_overwrite_accounting();
+#endif
+    return 0;
+}
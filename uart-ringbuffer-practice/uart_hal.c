@@ -1,47 +1,199 @@
 #include "uart_hal.h"
+#include "uart_regs.h"
 
 // --- Replace these with your MCU's registers/driver ---
-#define UART_SR_RXNE   (1u << 5)
-#define UART_SR_TXE    (1u << 7)
-volatile uint32_t UART_SR;
-volatile uint8_t  UART_DR;
-volatile uint32_t UART_CR1;
-#define UART_CR1_RXNEIE (1u << 5)
+volatile uint32_t  UART_SR;
+volatile uint8_t   UART_DR;
+volatile uint32_t  UART_CR1;
+volatile uint32_t  UART_CR3;
+volatile uint32_t  DMA_CCR;
+volatile uint32_t  DMA_CNDTR;
+volatile uintptr_t DMA_CMAR;
+volatile uint32_t  DMA_ISR;
+volatile uint32_t  DMA_IFCR;
 // ------------------------------------------------------
 
-ring_buffer_t uart_rx_buffer;
+#define RB_NAME    uart_tx_ring
+#define RB_SIZE    UART_TX_BUFFER_SIZE
+#define RB_INDEX_T UART_TX_INDEX_T
+#define RB_DEFINE
+#include "ringbuf_template.h"
+
+ring_buffer_t  uart_rx_buffer;
+uart_tx_ring_t uart_tx_buffer;
+uart_rx_telemetry_t uart_rx_telemetry;
+
+// DMA mode: where the DMA write pointer was at the previous event
+static uint32_t dma_last_pos;
+
+// Consumer wakeup: thresholds, and the batch the consumer is timing
+static volatile uint32_t rx_wake_level = UART_RX_WAKE_LEVEL;
+static volatile uint32_t rx_wake_timeout_us = UART_RX_WAKE_TIMEOUT_US;
+static bool     rx_batch_open;
+static uint32_t rx_batch_start_us;
 
 void uart_init(void) {
     ring_buffer_init(&uart_rx_buffer);
+    uart_tx_ring_init(&uart_tx_buffer);
+    rx_batch_open = false;
     UART_CR1 |= UART_CR1_RXNEIE; // enable RX IRQ
 }
 
+void uart_init_dma(void) {
+    ring_buffer_init(&uart_rx_buffer);
+    uart_tx_ring_init(&uart_tx_buffer);
+    dma_last_pos = 0;
+    rx_batch_open = false;
+
+    // circular DMA straight into the ring storage, IRQ at half and full lap
+    DMA_CCR = 0;
+    DMA_CMAR = (uintptr_t)uart_rx_buffer.buffer;
+    DMA_CNDTR = RING_BUFFER_SIZE;
+    DMA_CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_EN;
+
+    UART_CR3 |= UART_CR3_DMAR;                          // RXNE -> DMA request
+    UART_CR1 = (UART_CR1 & ~UART_CR1_RXNEIE) | UART_CR1_IDLEIE;
+}
+
 void uart_tx_byte(uint8_t b) {
-    while (!(UART_SR & UART_SR_TXE)) { /* wait */ }
-    UART_DR = b;
+    while (!(UART_SR & UART_SR_TXE)) { UART_CPU_RELAX(); }
+    UART_WRITE_DR(b);
+}
+
+uint32_t uart_write(const uint8_t *buf, uint32_t len) {
+    uint32_t n = uart_tx_ring_push_n(&uart_tx_buffer, buf, len);
+    if (n) {
+        // the TXE handler clears TXEIE when it runs dry; keep the RMW atomic
+        UART_IRQ_DISABLE();
+        UART_CR1 |= UART_CR1_TXEIE;
+        UART_IRQ_ENABLE();
+    }
+    return n;
+}
+
+void uart_flush(void) {
+    while (!uart_tx_ring_is_empty(&uart_tx_buffer) || !(UART_SR & UART_SR_TC)) {
+        UART_CPU_RELAX();
+    }
+}
+
+// ISR side of uart_rx_wait: wake the consumer when data shows up (it starts
+// the batch timer) and when the wake level is reached, not on every byte.
+static void rx_notify(uint32_t before) {
+    uint32_t level = ring_buffer_level(&uart_rx_buffer);
+    if ((before == 0 && level != 0) ||
+        (before < rx_wake_level && level >= rx_wake_level)) {
+        UART_WAKE();
+    }
 }
 
 void uart_rx_isr_byte(uint8_t b) {
+    uint32_t before = ring_buffer_level(&uart_rx_buffer);
     (void)ring_buffer_push(&uart_rx_buffer, b);
+    rx_notify(before);
+}
+
+void uart_rx_dma_event(void) {
+    // DMA_CNDTR counts down from RING_BUFFER_SIZE; 0 right at the wrap
+    uint32_t pos = (RING_BUFFER_SIZE - DMA_CNDTR) & RING_BUFFER_MASK;
+    uint32_t n = (pos - dma_last_pos) & RING_BUFFER_MASK;
+    dma_last_pos = pos;
+    if (n) {
+        uint32_t before = ring_buffer_level(&uart_rx_buffer);
+        (void)ring_buffer_publish(&uart_rx_buffer, n);
+        rx_notify(before);
+    }
 }
 
 // Example IRQ handler that reads DR then calls our ISR glue.
 void USART1_IRQHandler(void) {
-    if (UART_SR & UART_SR_RXNE) {
+    // in DMA mode RXNEIE is off and RXNE is the DMA's request: leave DR to it
+    if ((UART_SR & UART_SR_RXNE) && (UART_CR1 & UART_CR1_RXNEIE)) {
         uint8_t byte = UART_DR;   // read clears RXNE
         uart_rx_isr_byte(byte);
     }
+    if ((UART_SR & UART_SR_IDLE) && (UART_CR1 & UART_CR1_IDLEIE)) {
+        (void)UART_DR;            // SR then DR read clears IDLE
+        uart_rx_dma_event();      // flush the partial chunk of a burst
+    }
+    if ((UART_SR & UART_SR_TXE) && (UART_CR1 & UART_CR1_TXEIE)) {
+        uint8_t byte;
+        if (uart_tx_ring_pop(&uart_tx_buffer, &byte)) {
+            UART_WRITE_DR(byte);  // write clears TXE
+        } else {
+            UART_CR1 &= ~UART_CR1_TXEIE;  // ring drained
+        }
+    }
+}
+
+// RX DMA channel: half-transfer and transfer-complete.
+void DMA1_Channel5_IRQHandler(void) {
+    uint32_t flags = DMA_ISR & (DMA_ISR_HTIF | DMA_ISR_TCIF);
+    if (flags) {
+        DMA_IFCR = flags;
+        uart_rx_dma_event();
+    }
+}
+
+void uart_rx_set_wakeup(uint32_t level, uint32_t timeout_us) {
+    rx_wake_level = level ? level : 1u;
+    rx_wake_timeout_us = timeout_us;
+}
+
+uint32_t uart_rx_wait(uint32_t max_us) {
+    uint32_t start = UART_NOW_US();
+    for (;;) {
+        // masked from the check until the sleep, so an edge in between
+        // leaves its interrupt pending and the sleep returns at once
+        UART_IRQ_DISABLE();
+        uint32_t level = ring_buffer_level(&uart_rx_buffer);
+        uint32_t now = UART_NOW_US();
+        uint32_t sleep_us = UART_RX_WAIT_FOREVER;
+        bool batch = level >= rx_wake_level;
+        bool expired = false;
+
+        if (level == 0) {
+            rx_batch_open = false;
+        } else if (!rx_batch_open) {
+            rx_batch_open = true;
+            rx_batch_start_us = now;
+        }
+        if (rx_batch_open && !batch) {
+            uint32_t age = now - rx_batch_start_us;
+            if (age >= rx_wake_timeout_us) batch = true;
+            else sleep_us = rx_wake_timeout_us - age;
+        }
+        if (max_us != UART_RX_WAIT_FOREVER) {
+            uint32_t waited = now - start;
+            if (waited >= max_us) expired = true;
+            else if (max_us - waited < sleep_us) sleep_us = max_us - waited;
+        }
+        if (batch || expired) {
+            if (batch) rx_batch_open = false;   // the consumer takes it now
+            UART_IRQ_ENABLE();
+            return level;
+        }
+        UART_WAIT_FOR_IRQ(sleep_us);
+        UART_IRQ_ENABLE();
+    }
 }
 
 void uart_echo_task(void) {
-    uint8_t byte;
-    while (ring_buffer_pop(&uart_rx_buffer, &byte)) {
-        uart_tx_byte(byte);
+    ring_buffer_span_t span[2];
+    while (ring_buffer_peek(&uart_rx_buffer, span)) {
+        // copy each contiguous run into the TX ring, release what was taken
+        for (int s = 0; s < 2; ++s) {
+            uint32_t n = uart_write(span[s].data, span[s].len);
+            ring_buffer_commit(&uart_rx_buffer, n);
+            if (n < span[s].len) return;  // TX ring full: rest waits in RX
+        }
     }
 }
 
 void uart_monitor_task(void) {
-    ring_buffer_status_t st;
-    ring_buffer_get_status(&uart_rx_buffer, &st);
-    // Hook: if (st.high_wm_active) assert RTS / slow producer, etc.
+    ring_buffer_status_t *st = &uart_rx_telemetry.status;
+    ring_buffer_get_status(&uart_rx_buffer, st);
+    ring_buffer_stats(&uart_rx_buffer, &uart_rx_telemetry.stats, false);
+    // Hook: if (st->high_wm_active) assert RTS / slow producer, etc.
+    (void)st;
 }
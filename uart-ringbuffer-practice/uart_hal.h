@@ -3,20 +3,71 @@
 #include <stdbool.h>
 #include "ringbuf.h"
 
+// TX ring: main produces (uart_write), TXE interrupt consumes
+#define RB_NAME    uart_tx_ring
+#define RB_SIZE    UART_TX_BUFFER_SIZE
+#define RB_INDEX_T UART_TX_INDEX_T
+#include "ringbuf_template.h"
+
 // Global RX buffer instance used by ISR + main
 extern ring_buffer_t uart_rx_buffer;
 
+// Global TX buffer instance used by main + TXE ISR
+extern uart_tx_ring_t uart_tx_buffer;
+
 // Init UART (configure, enable RX interrupt, init ring buffer)
 void uart_init(void);
 
-// Blocking TX (demo)
+// Init UART in DMA receive mode: a circular DMA writes straight into
+// uart_rx_buffer storage; half-transfer, transfer-complete and idle-line
+// events publish the new bytes in chunks (no per-byte interrupt).
+// The DMA overwrites unread bytes when the consumer falls a lap behind, so
+// this mode behaves as overwrite-oldest; lost bytes still count as overflow.
+void uart_init_dma(void);
+
+// Blocking TX (demo). Writes DR directly; do not mix with uart_write.
 void uart_tx_byte(uint8_t b);
 
+// Non-blocking TX: queue up to len bytes in the TX ring and arm the TXE
+// interrupt. Returns the number of bytes queued (less than len when full).
+uint32_t uart_write(const uint8_t *buf, uint32_t len);
+
+// Wait until everything queued by uart_write has left the shift register.
+void uart_flush(void);
+
 // ISR entry (call from your actual IRQ handler)
 void uart_rx_isr_byte(uint8_t b);
 
-// Echo task (drain buffer to TX)
+// DMA mode ISR entry: publish what the DMA wrote since the last event
+void uart_rx_dma_event(void);
+
+// IRQ handlers (wire into the vector table)
+void USART1_IRQHandler(void);
+void DMA1_Channel5_IRQHandler(void);
+
+// Event-driven consumer: sleep until RX holds the wake level, or the oldest
+// unread byte has waited the batching timeout, or max_us has passed.
+// Returns the RX level. The RX ISR only signals the empty -> non-empty and
+// below -> at-level edges, so a batch costs at most two wakeups.
+// Target: WFI with interrupts masked. Host: uart_sim (eventfd in real time).
+#define UART_RX_WAIT_FOREVER UINT32_MAX
+uint32_t uart_rx_wait(uint32_t max_us);
+
+// Change the wake level (bytes) and batching timeout; config.h has defaults.
+void uart_rx_set_wakeup(uint32_t level, uint32_t timeout_us);
+
+// Echo task (move RX to the TX ring; what does not fit stays in RX)
 void uart_echo_task(void);
 
-// Optional: status poll
+// Latest numbers published by uart_monitor_task(). stats stays zero unless
+// built with RING_BUFFER_INSTRUMENT; take reset-on-read windows with
+// ring_buffer_stats(&uart_rx_buffer, &s, true).
+typedef struct {
+    ring_buffer_status_t status;
+    ring_buffer_stats_t  stats;
+} uart_rx_telemetry_t;
+
+extern uart_rx_telemetry_t uart_rx_telemetry;
+
+// Optional: status poll (publishes uart_rx_telemetry)
 void uart_monitor_task(void);
@@ -0,0 +1,139 @@
+// uart_harness.c - real-time host harness for sizing the RX ring.
+//
+// The line is driven by uart_sim in real-time mode: a periodic SIGALRM plays
+// the interrupt and feeds bytes at the configured baud rate and burst
+// pattern. The main loop drains uart_rx_buffer, then stalls for a random
+// "other work" slice, like a superloop with jitter.
+//
+// Build with -DRING_BUFFER_SIZE=N (and -DOVERWRITE_OLDEST) to compare sizes
+// and policies on the same traffic.
+//
+// usage: uart_harness [-b baud] [-B burst_bytes] [-g gap_us] [-n total_bytes]
+//                     [-w work_us] [-j jitter_us] [-t tick_us] [-d] [-e] [-s seed]
+//   -w/-j  each loop stalls work_us + rand() % (jitter_us + 1)
+//   -d     DMA receive mode instead of the RXNE interrupt
+//   -e     event-driven: sleep in uart_rx_wait (eventfd) before each pass
+//          instead of spinning; compare the cpu line with and without
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "uart_hal.h"
+#include "uart_sim.h"
+
+int main(int argc, char **argv) {
+    uint32_t baud = 115200, burst = 512, tick_us = 100, seed = 1;
+    uint64_t gap_us = 10000, total = 256u * 1024u, work_us = 200, jitter_us = 2000;
+    int dma = 0, event = 0, opt;
+
+    while ((opt = getopt(argc, argv, "b:B:g:n:w:j:t:des:")) != -1) {
+        switch (opt) {
+        case 'b': baud = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'B': burst = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'g': gap_us = strtoull(optarg, NULL, 0); break;
+        case 'n': total = strtoull(optarg, NULL, 0); break;
+        case 'w': work_us = strtoull(optarg, NULL, 0); break;
+        case 'j': jitter_us = strtoull(optarg, NULL, 0); break;
+        case 't': tick_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'd': dma = 1; break;
+        case 'e': event = 1; break;
+        case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        default:
+            fprintf(stderr, "usage: %s [-b baud] [-B burst] [-g gap_us] [-n bytes] "
+                            "[-w work_us] [-j jitter_us] [-t tick_us] [-d] [-e] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    uart_sim_reset();
+    uart_sim_set_baud(baud);
+    if (dma) uart_init_dma(); else uart_init();
+    uart_sim_set_traffic(burst, gap_us * 1000u, total);
+    srand(seed);
+    if (uart_sim_rt_start(tick_us) != 0) {
+        perror("uart_sim_rt_start");
+        return 1;
+    }
+
+    uint64_t consumed = 0, seq_breaks = 0, loops = 0, worst_stall = 0;
+    uint8_t expect = 0;
+    ring_buffer_span_t span[2];
+    uint64_t t_start = uart_sim_now_ns();
+
+    while (!uart_sim_traffic_done() || !ring_buffer_is_empty(&uart_rx_buffer)) {
+        uint32_t n;
+        if (event) uart_rx_wait(10000u);    // bounded: the loop checks for the end
+        while ((n = ring_buffer_peek(&uart_rx_buffer, span)) != 0) {
+            for (int s = 0; s < 2; ++s) {
+                for (uint32_t i = 0; i < span[s].len; ++i) {
+                    seq_breaks += span[s].data[i] != expect;
+                    expect = (uint8_t)(span[s].data[i] + 1u);
+                }
+            }
+            ring_buffer_commit(&uart_rx_buffer, n);
+            consumed += n;
+        }
+
+        uint64_t stall = (work_us + (uint64_t)rand() % (jitter_us + 1u)) * 1000u;
+        if (stall > worst_stall) worst_stall = stall;
+        uart_sim_advance(stall);
+        uart_monitor_task();
+        loops++;
+    }
+    uint64_t elapsed = uart_sim_now_ns() - t_start;
+    uart_sim_rt_stop();
+
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    double cpu = ru.ru_utime.tv_sec + ru.ru_stime.tv_sec +
+                 (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+
+    ring_buffer_status_t st;
+    ring_buffer_get_status(&uart_rx_buffer, &st);
+    double offered = baud / 10.0;
+
+    printf("config      : ring %u B (%s), %s%s, %u baud, bursts %u B / %llu us gap, "
+           "loop %llu+%llu us, tick %u us\n",
+           RING_BUFFER_SIZE,
+#ifdef OVERWRITE_OLDEST
+           "overwrite-oldest",
+#else
+           "drop-newest",
+#endif
+           dma ? "dma" : "rxne-isr", event ? ", event-driven" : "",
+           baud, burst, (unsigned long long)gap_us,
+           (unsigned long long)work_us, (unsigned long long)jitter_us, tick_us);
+    printf("elapsed     : %.3f s, %llu loops, worst stall %.2f ms\n",
+           elapsed / 1e9, (unsigned long long)loops, worst_stall / 1e6);
+    printf("cpu         : %.1f%% (%.3f s user+sys, includes the tick)\n",
+           100.0 * cpu / (elapsed / 1e9), cpu);
+    printf("throughput  : %.0f B/s sustained (line max %.0f B/s)\n",
+           consumed / (elapsed / 1e9), offered);
+    printf("delivered   : %llu of %llu B, %llu sequence breaks\n",
+           (unsigned long long)consumed, (unsigned long long)uart_sim_stats.rx_bytes,
+           (unsigned long long)seq_breaks);
+    printf("overflow    : %u\n", st.overflow_count);
+    printf("watermark   : %u trips (high %u / low %u)\n",
+           uart_sim_stats.rx_wm_trips, HIGH_WATERMARK, LOW_WATERMARK);
+    printf("worst fill  : %u B (%u%% of %u)\n", uart_sim_stats.rx_peak_level,
+           uart_sim_stats.rx_peak_level * 100u / RING_BUFFER_SIZE, RING_BUFFER_SIZE);
+    printf("interrupts  : %llu usart, %llu dma\n",
+           (unsigned long long)uart_sim_stats.usart_irqs,
+           (unsigned long long)uart_sim_stats.dma_irqs);
+
+#ifdef RING_BUFFER_INSTRUMENT
+    // what firmware would see through uart_monitor_task()
+    const ring_buffer_stats_t *rs = &uart_rx_telemetry.stats;
+    printf("ring stats  : peak %u B, %u watermark trips, %u bytes timed\n",
+           rs->peak_level, rs->wm_trips, rs->lat_samples);
+    printf("latency     : RING_BUFFER_CYCLES() ticks, log2 buckets\n");
+    for (uint32_t k = 0; k < RING_BUFFER_LAT_BUCKETS; ++k) {
+        if (!rs->lat_hist[k]) continue;
+        printf("  < 2^%-2u %10u  %5.1f%%\n", k, rs->lat_hist[k],
+               100.0 * rs->lat_hist[k] / rs->lat_samples);
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,255 @@
+#define _DEFAULT_SOURCE          // cfmakeraw, B921600 and up
+#include "uart_linux.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RB_NAME    uart_tx_ring
+#define RB_SIZE    UART_TX_BUFFER_SIZE
+#define RB_INDEX_T UART_TX_INDEX_T
+#define RB_DEFINE
+#include "ringbuf_template.h"
+
+ring_buffer_t  uart_rx_buffer;
+uart_tx_ring_t uart_tx_buffer;
+uart_rx_telemetry_t uart_rx_telemetry;
+uart_linux_stats_t  uart_linux_stats;
+
+static int      tty_fd = -1;
+static int      ep_fd = -1;
+static uint32_t ep_events;      // interest currently registered
+static bool     hung_up;
+
+// same wake rules as the MCU HAL (uart_rx_wait)
+static uint32_t rx_wake_level = UART_RX_WAKE_LEVEL;
+static uint32_t rx_wake_timeout_us = UART_RX_WAKE_TIMEOUT_US;
+static bool     rx_batch_open;
+static uint64_t rx_batch_start_us;
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static int baud_to_speed(uint32_t baud, speed_t *sp) {
+    static const struct { uint32_t baud; speed_t speed; } map[] = {
+        { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 },
+        { 115200, B115200 }, { 230400, B230400 }, { 460800, B460800 },
+        { 921600, B921600 }, { 1000000, B1000000 }, { 1500000, B1500000 },
+        { 2000000, B2000000 }, { 3000000, B3000000 }, { 4000000, B4000000 },
+    };
+    for (size_t i = 0; i < sizeof map / sizeof map[0]; ++i) {
+        if (map[i].baud == baud) {
+            *sp = map[i].speed;
+            return 0;
+        }
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+int uart_linux_attach(int fd, uint32_t baud) {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) return -1;
+    cfmakeraw(&tio);                        // 8N1, no echo, no line editing
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(tcflag_t)CRTSCTS;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    if (baud) {
+        speed_t sp;
+        if (baud_to_speed(baud, &sp) != 0 || cfsetspeed(&tio, sp) != 0) return -1;
+    }
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) return -1;
+
+    int fl = fcntl(fd, F_GETFL);
+    if (fl < 0 || fcntl(fd, F_SETFL, fl | O_NONBLOCK) != 0) return -1;
+
+    if (ep_fd < 0 && (ep_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) return -1;
+    struct epoll_event ev = { .events = EPOLLIN, .data.fd = fd };
+    if (epoll_ctl(ep_fd, EPOLL_CTL_ADD, fd, &ev) != 0) return -1;
+    ep_events = EPOLLIN;
+    tty_fd = fd;
+    hung_up = false;
+    return 0;
+}
+
+int uart_linux_open(const char *path, uint32_t baud) {
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+    if (uart_linux_attach(fd, baud) != 0) {
+        int e = errno;
+        close(fd);
+        errno = e;
+        return -1;
+    }
+    return 0;
+}
+
+void uart_linux_close(void) {
+    if (tty_fd >= 0) close(tty_fd);
+    if (ep_fd >= 0) close(ep_fd);
+    tty_fd = ep_fd = -1;
+}
+
+void uart_init(void) {
+    ring_buffer_init(&uart_rx_buffer);
+    uart_tx_ring_init(&uart_tx_buffer);
+    rx_batch_open = false;
+    uart_linux_stats = (uart_linux_stats_t){0};
+}
+
+void uart_init_dma(void) {
+    uart_init();
+}
+
+// readv into the free spans: one call fills as much as the tty has ready
+static void rx_fill(uint32_t events) {
+    ring_buffer_wspan_t span[2];
+    if (ring_buffer_reserve(&uart_rx_buffer, span) == 0) {
+        // epoll reports HUP/ERR even without EPOLLIN in the interest set;
+        // with no room to read the end of the stream, give up on the tty
+        // now instead of returning from every poll at once
+        if (events & (EPOLLHUP | EPOLLERR)) hung_up = true;
+        return;
+    }
+
+    struct iovec iov[2] = {
+        { span[0].data, span[0].len },
+        { span[1].data, span[1].len },
+    };
+    ssize_t n = readv(tty_fd, iov, span[1].len ? 2 : 1);
+    uart_linux_stats.reads++;
+    if (n > 0) {
+        ring_buffer_publish(&uart_rx_buffer, (uint32_t)n);
+        uart_linux_stats.rx_bytes += (uint64_t)n;
+    } else if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+        hung_up = true;                     // pty master closed, device gone
+    }
+}
+
+// writev out of the readable spans, release what the tty took
+static void tx_drain(void) {
+    ring_buffer_span_t span[2];
+    if (uart_tx_ring_peek(&uart_tx_buffer, span) == 0 || hung_up) return;
+
+    struct iovec iov[2] = {
+        { (void *)span[0].data, span[0].len },
+        { (void *)span[1].data, span[1].len },
+    };
+    ssize_t n = writev(tty_fd, iov, span[1].len ? 2 : 1);
+    uart_linux_stats.writes++;
+    if (n > 0) {
+        uart_tx_ring_commit(&uart_tx_buffer, (uint32_t)n);
+        uart_linux_stats.tx_bytes += (uint64_t)n;
+    } else if (n < 0 && errno != EAGAIN && errno != EINTR) {
+        hung_up = true;
+    }
+}
+
+int uart_linux_poll(int timeout_ms) {
+    if (tty_fd < 0 || hung_up) return -1;
+
+    // read only while RX has room, ask for POLLOUT only while TX has data;
+    // epoll_ctl only when that changes
+    uint32_t want = 0;
+    if (!ring_buffer_is_full(&uart_rx_buffer)) want |= EPOLLIN;
+    if (!uart_tx_ring_is_empty(&uart_tx_buffer)) want |= EPOLLOUT;
+    if (want != ep_events) {
+        struct epoll_event ev = { .events = want, .data.fd = tty_fd };
+        epoll_ctl(ep_fd, EPOLL_CTL_MOD, tty_fd, &ev);
+        uart_linux_stats.ctls++;
+        ep_events = want;
+    }
+
+    struct epoll_event ev;
+    int n = epoll_wait(ep_fd, &ev, 1, timeout_ms);
+    uart_linux_stats.waits++;
+    if (n <= 0) return (n < 0 && errno != EINTR) ? -1 : 0;
+
+    if (ev.events & (EPOLLIN | EPOLLHUP | EPOLLERR)) rx_fill(ev.events);
+    if (ev.events & EPOLLOUT) tx_drain();
+    return hung_up ? -1 : 1;
+}
+
+void uart_tx_byte(uint8_t b) {
+    while (uart_write(&b, 1) == 0) {
+        if (uart_linux_poll(-1) < 0) return;
+    }
+}
+
+uint32_t uart_write(const uint8_t *buf, uint32_t len) {
+    uint32_t n = uart_tx_ring_push_n(&uart_tx_buffer, buf, len);
+    if (n) tx_drain();      // start now; epoll takes over if the tty is busy
+    return n;
+}
+
+void uart_flush(void) {
+    while (!uart_tx_ring_is_empty(&uart_tx_buffer)) {
+        if (uart_linux_poll(-1) < 0) return;
+    }
+    tcdrain(tty_fd);
+}
+
+void uart_rx_set_wakeup(uint32_t level, uint32_t timeout_us) {
+    rx_wake_level = level ? level : 1u;
+    rx_wake_timeout_us = timeout_us;
+}
+
+uint32_t uart_rx_wait(uint32_t max_us) {
+    uint64_t start = now_us();
+    for (;;) {
+        uint32_t level = ring_buffer_level(&uart_rx_buffer);
+        uint64_t now = now_us();
+        uint64_t sleep_us = UINT64_MAX;
+        bool batch = level >= rx_wake_level;
+        bool expired = false;
+
+        if (level == 0) {
+            rx_batch_open = false;
+        } else if (!rx_batch_open) {
+            rx_batch_open = true;
+            rx_batch_start_us = now;
+        }
+        if (rx_batch_open && !batch) {
+            uint64_t age = now - rx_batch_start_us;
+            if (age >= rx_wake_timeout_us) batch = true;
+            else sleep_us = rx_wake_timeout_us - age;
+        }
+        if (max_us != UART_RX_WAIT_FOREVER) {
+            uint64_t waited = now - start;
+            if (waited >= max_us) expired = true;
+            else if (max_us - waited < sleep_us) sleep_us = max_us - waited;
+        }
+        // a full TX ring stalls any echo-style consumer: drain it first
+        if (uart_tx_ring_is_full(&uart_tx_buffer) && !expired) batch = false;
+        if (batch || expired) {
+            if (batch) rx_batch_open = false;
+            return level;
+        }
+        int ms = sleep_us == UINT64_MAX ? -1 : (int)((sleep_us + 999u) / 1000u);
+        if (uart_linux_poll(ms) < 0) return ring_buffer_level(&uart_rx_buffer);
+    }
+}
+
+void uart_echo_task(void) {
+    ring_buffer_span_t span[2];
+    while (ring_buffer_peek(&uart_rx_buffer, span)) {
+        for (int s = 0; s < 2; ++s) {
+            uint32_t n = uart_write(span[s].data, span[s].len);
+            ring_buffer_commit(&uart_rx_buffer, n);
+            if (n < span[s].len) return;  // TX ring full: rest waits in RX
+        }
+    }
+}
+
+void uart_monitor_task(void) {
+    ring_buffer_get_status(&uart_rx_buffer, &uart_rx_telemetry.status);
+    ring_buffer_stats(&uart_rx_buffer, &uart_rx_telemetry.stats, false);
+}
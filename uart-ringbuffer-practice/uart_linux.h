@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+#include "uart_hal.h"
+
+// Linux backend for the uart_hal.h API: a real tty (or a pty) instead of the
+// fake registers. Link uart_linux.c in place of uart_hal.c and uart_sim.c.
+//
+// RX: readv() straight into the RX ring's free spans (reserve/publish).
+// TX: writev() straight out of the TX ring's readable spans (peek/commit).
+// No byte is staged in a temporary buffer. epoll waits for the tty; the RX
+// wake level / batching timeout of uart_rx_wait() decide how much is read
+// before the consumer runs. Size the rings for the line rate, e.g.
+// -DRING_BUFFER_SIZE=65536 -DUART_TX_BUFFER_SIZE=65536.
+//
+// Provided: uart_init (uart_init_dma is the same here: the kernel driver
+// already batches), uart_tx_byte, uart_write, uart_flush, uart_rx_wait,
+// uart_rx_set_wakeup, uart_echo_task, uart_monitor_task. The ISR entries
+// and IRQ handlers do not exist on this backend.
+
+typedef struct {
+    uint64_t rx_bytes;
+    uint64_t tx_bytes;
+    uint64_t reads;     // readv calls
+    uint64_t writes;    // writev calls
+    uint64_t waits;     // epoll_wait calls
+    uint64_t ctls;      // epoll_ctl calls (interest changes)
+} uart_linux_stats_t;
+
+extern uart_linux_stats_t uart_linux_stats;
+
+// Open and configure a tty (raw 8N1, no flow control, non-blocking), before
+// uart_init(). baud 0 leaves the speed alone (ptys). Returns 0, or -1 with errno.
+int  uart_linux_open(const char *path, uint32_t baud);
+
+// Same for an fd that is already open, e.g. the slave side of openpty().
+int  uart_linux_attach(int fd, uint32_t baud);
+
+void uart_linux_close(void);
+
+// One I/O round: wait up to timeout_ms (-1 forever) for the tty, readv into
+// the RX ring, writev from the TX ring. Returns 1 if anything moved, 0 on
+// timeout, -1 when the tty is gone (hangup or error). A hangup that arrives
+// while RX is full ends it too: what the tty still held is lost.
+int  uart_linux_poll(int timeout_ms);
@@ -0,0 +1,73 @@
+#pragma once
+#include <stdint.h>
+
+// --- Replace these with your MCU's registers/driver ---
+// Stand-ins for USART1 and its RX DMA channel (STM32F1-style bit layout).
+// On the host they are plain globals driven by uart_sim.c.
+
+#define UART_SR_IDLE    (1u << 4)
+#define UART_SR_RXNE    (1u << 5)
+#define UART_SR_TC      (1u << 6)
+#define UART_SR_TXE     (1u << 7)
+#define UART_CR1_IDLEIE (1u << 4)
+#define UART_CR1_RXNEIE (1u << 5)
+#define UART_CR1_TXEIE  (1u << 7)
+#define UART_CR3_DMAR   (1u << 6)
+
+extern volatile uint32_t UART_SR;
+extern volatile uint8_t  UART_DR;
+extern volatile uint32_t UART_CR1;
+extern volatile uint32_t UART_CR3;
+
+#define DMA_CCR_EN      (1u << 0)
+#define DMA_CCR_TCIE    (1u << 1)
+#define DMA_CCR_HTIE    (1u << 2)
+#define DMA_CCR_CIRC    (1u << 5)
+#define DMA_CCR_MINC    (1u << 7)
+#define DMA_ISR_TCIF    (1u << 1)
+#define DMA_ISR_HTIF    (1u << 2)
+
+extern volatile uint32_t  DMA_CCR;    // channel config
+extern volatile uint32_t  DMA_CNDTR;  // bytes left in the current lap (counts down)
+extern volatile uintptr_t DMA_CMAR;   // memory address
+extern volatile uint32_t  DMA_ISR;    // status flags
+extern volatile uint32_t  DMA_IFCR;   // write 1 to clear the matching DMA_ISR flag
+
+// Accesses with side effects the host model has to see, plus interrupt
+// masking for read-modify-write of registers an ISR also touches.
+//
+// Sleeping: UART_WAIT_FOR_IRQ is entered with interrupts masked and returns
+// after an interrupt became pending (it runs once they are unmasked), so a
+// wakeup between the check and the sleep is never lost. UART_WAKE is what
+// the RX ISR does to end that sleep; UART_NOW_US is a free-running
+// microsecond clock for the batching timeout.
+#if defined(__arm__)
+uint32_t board_now_us(void);        // e.g. a free-running timer or DWT->CYCCNT scaled
+# define UART_WRITE_DR(b)   (UART_DR = (b))
+# define UART_IRQ_DISABLE() __asm__ volatile ("cpsid i" ::: "memory")
+# define UART_IRQ_ENABLE()  __asm__ volatile ("cpsie i" ::: "memory")
+# define UART_CPU_RELAX()   __asm__ volatile ("nop")
+// WFI wakes on any interrupt; a periodic tick (SysTick) has to be running
+// for the timeout to expire, timeout_us is only a hint here.
+# define UART_WAIT_FOR_IRQ(timeout_us) \
+    do { (void)(timeout_us); __asm__ volatile ("wfi" ::: "memory"); } while (0)
+# define UART_WAKE()        ((void)0)    // the RX interrupt itself ends WFI
+# define UART_NOW_US()      board_now_us()
+#else
+// host: uart_sim.c plays the peripheral and the interrupt controller
+void     uart_sim_write_dr(uint8_t b);
+void     uart_sim_irq_disable(void);
+void     uart_sim_irq_enable(void);
+void     uart_sim_cpu_relax(void);
+void     uart_sim_wait_irq(uint32_t timeout_us);
+void     uart_sim_wake(void);
+uint32_t uart_sim_now_us(void);
+# define UART_WRITE_DR(b)   uart_sim_write_dr(b)
+# define UART_IRQ_DISABLE() uart_sim_irq_disable()
+# define UART_IRQ_ENABLE()  uart_sim_irq_enable()
+# define UART_CPU_RELAX()   uart_sim_cpu_relax()
+# define UART_WAIT_FOR_IRQ(timeout_us) uart_sim_wait_irq(timeout_us)
+# define UART_WAKE()        uart_sim_wake()
+# define UART_NOW_US()      uart_sim_now_us()
+#endif
+// ------------------------------------------------------
@@ -0,0 +1,387 @@
+#define _POSIX_C_SOURCE 200809L
+#include "uart_sim.h"
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/select.h>
+#include <time.h>
+#include <unistd.h>
+#include "uart_hal.h"
+#include "uart_regs.h"
+
+uart_sim_stats_t uart_sim_stats;
+
+#define NEVER UINT64_MAX
+
+static uint32_t dma_reload;     // CNDTR value programmed at enable (circular reload)
+static int      irq_masked;     // UART_IRQ_DISABLE nesting
+static bool     in_irq;
+
+static uint64_t now_ns;
+static uint64_t byte_ns = 86806; // 115200 8N1
+
+// real-time mode
+static bool     rt;
+static timer_t  rt_timer;
+static uint64_t rt_origin_ns;   // CLOCK_MONOTONIC at now_ns == rt_base_ns
+static uint64_t rt_base_ns;
+static bool     rx_wm_was_set;
+
+// RX traffic (volatile: polled by main while the rt tick updates them)
+static uint32_t burst_len;
+static uint64_t gap_ns;
+static volatile uint64_t rx_left;   // bytes still to deliver
+static uint32_t burst_pos;
+static uint64_t next_rx_ns = NEVER;
+static volatile uint64_t idle_at_ns = NEVER;
+static uint8_t  rx_seq;
+
+// TX: data register + shift register
+static bool     tdr_full;
+static uint8_t  shift_byte;
+static uint64_t shift_done_ns = NEVER;
+
+// consumer sleep (UART_WAIT_FOR_IRQ / UART_WAKE) and echo latency
+static volatile sig_atomic_t woken;
+static int      wake_fd = -1;
+static uint64_t rx_at_ns[256];  // delivery time by sequence number
+
+void uart_sim_reset(void) {
+    uart_sim_rt_stop();
+    UART_SR = UART_SR_TXE | UART_SR_TC;   // transmitter idle
+    UART_CR1 = 0;
+    UART_CR3 = 0;
+    DMA_CCR = 0;
+    DMA_ISR = 0;
+    DMA_IFCR = 0;
+    dma_reload = 0;
+    irq_masked = 0;
+    in_irq = false;
+    now_ns = 0;
+    rx_left = 0;
+    next_rx_ns = idle_at_ns = shift_done_ns = NEVER;
+    tdr_full = false;
+    rx_seq = 0;
+    woken = 0;
+    rx_wm_was_set = false;
+    uart_sim_stats = (uart_sim_stats_t){0};
+}
+
+// Level-triggered: keep calling handlers while an enabled source is pending.
+// The handlers read DR whenever RXNE/IDLE is set, which clears those flags.
+static void check_irqs(void) {
+    if (irq_masked || in_irq) return;
+    in_irq = true;
+    for (;;) {
+        if (DMA_ISR & (DMA_ISR_HTIF | DMA_ISR_TCIF)) {
+            uart_sim_stats.dma_irqs++;
+            DMA1_Channel5_IRQHandler();
+            DMA_ISR &= ~DMA_IFCR;
+            DMA_IFCR = 0;
+            continue;
+        }
+        uint32_t sr = UART_SR, cr1 = UART_CR1;
+        if (((sr & UART_SR_RXNE) && (cr1 & UART_CR1_RXNEIE)) ||
+            ((sr & UART_SR_IDLE) && (cr1 & UART_CR1_IDLEIE)) ||
+            ((sr & UART_SR_TXE)  && (cr1 & UART_CR1_TXEIE))) {
+            uart_sim_stats.usart_irqs++;
+            USART1_IRQHandler();
+            UART_SR &= ~(UART_SR_RXNE | UART_SR_IDLE);
+            continue;
+        }
+        break;
+    }
+    in_irq = false;
+}
+
+static void deliver_rx(uint8_t b) {
+    uart_sim_stats.rx_bytes++;
+    rx_at_ns[b] = now_ns;
+
+    if ((UART_CR3 & UART_CR3_DMAR) && (DMA_CCR & DMA_CCR_EN)) {
+        if (!dma_reload) dma_reload = DMA_CNDTR;
+        uint8_t *mem = (uint8_t *)DMA_CMAR;
+        mem[dma_reload - DMA_CNDTR] = b;
+
+        uint32_t left = --DMA_CNDTR;
+        if (left == dma_reload / 2u && (DMA_CCR & DMA_CCR_HTIE)) DMA_ISR |= DMA_ISR_HTIF;
+        if (left == 0) {
+            if (DMA_CCR & DMA_CCR_TCIE) DMA_ISR |= DMA_ISR_TCIF;
+            if (DMA_CCR & DMA_CCR_CIRC) DMA_CNDTR = dma_reload;
+            else DMA_CCR &= ~DMA_CCR_EN;
+        }
+    } else {
+        UART_DR = b;
+        UART_SR |= UART_SR_RXNE;
+    }
+    check_irqs();
+    UART_SR &= ~UART_SR_RXNE;   // not read in time (masked/disabled): overrun, byte lost
+
+    uint32_t level = ring_buffer_level(&uart_rx_buffer);
+    if (level > uart_sim_stats.rx_peak_level) uart_sim_stats.rx_peak_level = level;
+    bool wm = uart_rx_buffer.high_wm_flag;
+    if (wm && !rx_wm_was_set) uart_sim_stats.rx_wm_trips++;
+    rx_wm_was_set = wm;
+}
+
+void uart_sim_rx_byte(uint8_t b) {
+    deliver_rx(b);
+}
+
+void uart_sim_rx_idle(void) {
+    UART_SR |= UART_SR_IDLE;
+    check_irqs();
+    UART_SR &= ~UART_SR_IDLE;
+}
+
+void uart_sim_write_dr(uint8_t b) {
+    if (rt && !in_irq) {
+        // from main: the tick must not run between these updates
+        uart_sim_irq_disable();
+        uart_sim_write_dr(b);
+        uart_sim_irq_enable();
+        return;
+    }
+    UART_DR = b;
+    UART_SR &= ~UART_SR_TC;
+    if (shift_done_ns == NEVER) {
+        // shift register idle: DR moves straight in, TXE stays set
+        shift_byte = b;
+        shift_done_ns = now_ns + byte_ns;
+    } else {
+        tdr_full = true;
+        UART_SR &= ~UART_SR_TXE;
+    }
+}
+
+static sigset_t rt_sigset(void) {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGALRM);
+    return set;
+}
+
+static uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void run_until(uint64_t end);
+
+void uart_sim_irq_disable(void) {
+    if (rt && irq_masked == 0) {
+        sigset_t set = rt_sigset();
+        sigprocmask(SIG_BLOCK, &set, NULL);
+    }
+    irq_masked++;
+}
+
+void uart_sim_irq_enable(void) {
+    if (--irq_masked != 0) return;
+    if (rt) {
+        // catch up with the line and take what the masked section left pending
+        run_until(rt_base_ns + (mono_ns() - rt_origin_ns));
+        check_irqs();
+        sigset_t set = rt_sigset();
+        sigprocmask(SIG_UNBLOCK, &set, NULL);
+    } else {
+        check_irqs();
+    }
+}
+
+void uart_sim_set_baud(uint32_t baud) {
+    byte_ns = 10ull * 1000000000ull / baud;
+}
+
+void uart_sim_set_traffic(uint32_t burst, uint64_t gap, uint64_t total_bytes) {
+    burst_len = burst ? burst : 1u;
+    gap_ns = gap;
+    rx_left = total_bytes;
+    burst_pos = 0;
+    next_rx_ns = total_bytes ? now_ns + byte_ns : NEVER;
+}
+
+bool uart_sim_traffic_done(void) {
+    return rx_left == 0 && idle_at_ns == NEVER;
+}
+
+static uint64_t next_event_ns(void) {
+    uint64_t t = next_rx_ns;
+    if (idle_at_ns < t) t = idle_at_ns;
+    if (shift_done_ns < t) t = shift_done_ns;
+    return t;
+}
+
+static void tx_done(uint8_t b) {
+    uint64_t lat = now_ns - rx_at_ns[b];
+    uart_sim_stats.tx_bytes++;
+    uart_sim_stats.echo_bytes++;
+    uart_sim_stats.echo_lat_sum_ns += lat;
+    if (lat > uart_sim_stats.echo_lat_max_ns) uart_sim_stats.echo_lat_max_ns = lat;
+}
+
+static void run_event(void) {
+    if (shift_done_ns == now_ns) {
+        tx_done(shift_byte);
+        if (tdr_full) {
+            tdr_full = false;
+            shift_byte = UART_DR;
+            shift_done_ns = now_ns + byte_ns;
+            UART_SR |= UART_SR_TXE;
+        } else {
+            shift_done_ns = NEVER;
+            UART_SR |= UART_SR_TC;
+        }
+        check_irqs();
+    }
+    if (next_rx_ns == now_ns) {
+        rx_left--;
+        idle_at_ns = NEVER;
+        if (++burst_pos < burst_len && rx_left) {
+            next_rx_ns = now_ns + byte_ns;
+        } else {
+            burst_pos = 0;
+            idle_at_ns = now_ns + byte_ns;
+            next_rx_ns = rx_left ? now_ns + byte_ns + gap_ns : NEVER;
+        }
+        deliver_rx(rx_seq++);
+    }
+    if (idle_at_ns == now_ns) {
+        idle_at_ns = NEVER;
+        uart_sim_rx_idle();
+    }
+}
+
+static void run_until(uint64_t end) {
+    for (;;) {
+        uint64_t t = next_event_ns();
+        if (t > end) break;
+        now_ns = t;
+        run_event();
+    }
+    if (end > now_ns) now_ns = end;
+}
+
+static void rt_tick(int sig) {
+    (void)sig;
+    if (irq_masked) return;     // cannot happen while blocked; belt and braces
+    run_until(rt_base_ns + (mono_ns() - rt_origin_ns));
+}
+
+void uart_sim_advance(uint64_t ns) {
+    if (rt) {
+        // busy for ns of wall time; the tick preempts us meanwhile
+        uint64_t end = mono_ns() + ns;
+        while (mono_ns() < end) { }
+        return;
+    }
+    run_until(now_ns + ns);
+}
+
+int uart_sim_rt_start(uint32_t tick_us) {
+    if (wake_fd < 0 && (wake_fd = eventfd(0, EFD_NONBLOCK)) < 0) return -1;
+
+    struct sigaction sa = {0};
+    sa.sa_handler = rt_tick;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGALRM, &sa, NULL) != 0) return -1;
+
+    struct sigevent sev = {0};
+    sev.sigev_notify = SIGEV_SIGNAL;
+    sev.sigev_signo = SIGALRM;
+    if (timer_create(CLOCK_MONOTONIC, &sev, &rt_timer) != 0) return -1;
+
+    rt_base_ns = now_ns;
+    rt_origin_ns = mono_ns();
+    rt = true;
+
+    struct itimerspec its = {0};
+    its.it_interval.tv_sec  = tick_us / 1000000u;
+    its.it_interval.tv_nsec = (long)(tick_us % 1000000u) * 1000;
+    its.it_value = its.it_interval;
+    if (timer_settime(rt_timer, 0, &its, NULL) != 0) {
+        rt = false;
+        timer_delete(rt_timer);
+        return -1;
+    }
+    return 0;
+}
+
+void uart_sim_rt_stop(void) {
+    if (!rt) return;
+    timer_delete(rt_timer);
+    rt = false;
+    signal(SIGALRM, SIG_DFL);
+}
+
+uint64_t uart_sim_now_ns(void) {
+    if (rt) return rt_base_ns + (mono_ns() - rt_origin_ns);
+    return now_ns;
+}
+
+uint32_t uart_sim_now_us(void) {
+    return (uint32_t)(uart_sim_now_ns() / 1000u);
+}
+
+void uart_sim_wake(void) {
+    woken = 1;
+    if (rt) {
+        uint64_t one = 1;
+        (void)!write(wake_fd, &one, sizeof one);   // async-signal-safe
+    }
+}
+
+// Called with "interrupts" masked. Like WFI they are taken while asleep.
+void uart_sim_wait_irq(uint32_t timeout_us) {
+    int masked = irq_masked;
+    uint64_t t0 = uart_sim_now_ns();
+    uint64_t end = t0 + (uint64_t)timeout_us * 1000u;
+    uint64_t drained;
+
+    // wakes from before the caller's check are stale; what was left
+    // pending while masked is taken below and may wake us right away
+    woken = 0;
+    if (rt) (void)!read(wake_fd, &drained, sizeof drained);
+    irq_masked = 0;
+    uart_sim_stats.wakeups++;
+    if (rt) {
+        // catch up with the line, then block on the eventfd with SIGALRM
+        // let through; ticks that do not wake us (EINTR) sleep again
+        run_until(uart_sim_now_ns());
+        check_irqs();
+        sigset_t open;
+        sigprocmask(SIG_BLOCK, NULL, &open);
+        sigdelset(&open, SIGALRM);
+        for (uint64_t now = t0; !woken && now < end; now = uart_sim_now_ns()) {
+            uint64_t left = end - now;
+            struct timespec ts = { (time_t)(left / 1000000000u), (long)(left % 1000000000u) };
+            fd_set rd;
+            FD_ZERO(&rd);
+            FD_SET(wake_fd, &rd);
+            if (pselect(wake_fd + 1, &rd, NULL, NULL, &ts, &open) > 0) break;
+        }
+    } else {
+        check_irqs();
+        while (!woken) {
+            uint64_t t = next_event_ns();
+            if (t > end) {
+                if (end > now_ns) now_ns = end;
+                break;
+            }
+            now_ns = t;
+            run_event();
+        }
+    }
+    uart_sim_stats.sleep_ns += uart_sim_now_ns() - t0;
+    irq_masked = masked;
+}
+
+void uart_sim_cpu_relax(void) {
+    if (rt) return;             // the tick moves the line; just spin
+    uint64_t t = next_event_ns();
+    if (t == NEVER) t = now_ns + byte_ns;   // nothing in flight: burn a byte time
+    uart_sim_stats.relax_ns += t - now_ns;
+    now_ns = t;
+    run_event();
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Host model of the USART1 line (RX + TX shift register) and its circular
+// RX DMA channel, driving the fake registers in uart_regs.h and calling the
+// IRQ handlers the way the NVIC would. Linux only; not part of a firmware
+// build.
+//
+// Time is virtual by default: it only moves when the "CPU" spends it, i.e.
+// in uart_sim_advance() (main-loop work) and uart_sim_cpu_relax() (busy-wait
+// iterations, which jump to the next line event). Runs are deterministic.
+//
+// Real-time mode (uart_sim_rt_start) follows CLOCK_MONOTONIC instead: a
+// periodic SIGALRM preempts the main thread like an interrupt, delivers every
+// byte that is due and runs the IRQ handlers in signal context.
+// UART_IRQ_DISABLE blocks the signal. The process must be single-threaded.
+//
+// UART_WAIT_FOR_IRQ sleeps until UART_WAKE or the timeout: virtual time jumps
+// ahead through the line events; in real time the thread blocks on an
+// eventfd that UART_WAKE (in the signal handler) writes.
+//
+// Echo latency: RX bytes carry a running sequence number, so a TX byte is
+// matched to the RX byte with the same value (valid while fewer than 256
+// bytes are in flight, i.e. for the default RX + TX ring sizes).
+
+typedef struct {
+    uint64_t rx_bytes;      // bytes delivered on the line
+    uint64_t tx_bytes;      // bytes fully shifted out
+    uint64_t usart_irqs;    // USART1_IRQHandler invocations
+    uint64_t dma_irqs;      // DMA1_Channel5_IRQHandler invocations
+    uint64_t relax_ns;      // virtual time spent in busy-wait loops
+    uint32_t rx_peak_level; // worst uart_rx_buffer fill seen after an RX interrupt
+    uint32_t rx_wm_trips;   // rising edges of uart_rx_buffer.high_wm_flag
+    uint64_t sleep_ns;      // time the CPU spent in UART_WAIT_FOR_IRQ
+    uint64_t wakeups;       // UART_WAIT_FOR_IRQ returns
+    uint64_t echo_bytes;    // TX bytes matched to the RX byte they echo
+    uint64_t echo_lat_sum_ns;   // RX byte delivered -> its echo fully shifted out
+    uint64_t echo_lat_max_ns;
+} uart_sim_stats_t;
+
+extern uart_sim_stats_t uart_sim_stats;
+
+// Forget line/DMA state, zero the clock and the stats (call before uart_init*()).
+void uart_sim_reset(void);
+
+// Direct injection, no timing: one byte arrives on the line (RXNE interrupt,
+// or a DMA write with HT/TC interrupts when UART_CR3_DMAR is set) ...
+void uart_sim_rx_byte(uint8_t b);
+// ... or the line has been idle for one frame after traffic (IDLE interrupt).
+void uart_sim_rx_idle(void);
+
+// Timed line: 8N1 at baud, RX traffic in bursts of burst_len back-to-back
+// bytes separated by gap_ns of silence, total_bytes in all.
+void     uart_sim_set_baud(uint32_t baud);
+void     uart_sim_set_traffic(uint32_t burst_len, uint64_t gap_ns, uint64_t total_bytes);
+bool     uart_sim_traffic_done(void);
+uint64_t uart_sim_now_ns(void);
+
+// The CPU is busy for ns: the line keeps running and interrupts still fire.
+void     uart_sim_advance(uint64_t ns);
+
+// Switch to real time with a tick_us interrupt period (from "now" on).
+// Returns 0, or -1 if the timer could not be created.
+int      uart_sim_rt_start(uint32_t tick_us);
+void     uart_sim_rt_stop(void);